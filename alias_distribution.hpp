@@ -0,0 +1,215 @@
+#ifndef ALIAS_DISTRIBUTION_H
+#define ALIAS_DISTRIBUTION_H
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iosfwd>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include "rand_util.hpp"
+
+// Drop-in replacement for std::discrete_distribution with O(1) sampling.
+// Vose, "A Linear Algorithm For Generating Random Numbers With a Given Distribution", 1991
+
+template <typename IntType = int>
+class alias_distribution
+{
+public:
+	using result_type = IntType;
+
+	class param_type
+	{
+	public:
+		using distribution_type = alias_distribution;
+
+		param_type() : prob(1, 1.0)
+		{
+			init();
+		}
+		template <typename InputIt>
+		param_type(InputIt first, InputIt last) : prob(first, last)
+		{
+			init();
+		}
+		param_type(std::initializer_list<double> wl) : prob(wl)
+		{
+			init();
+		}
+		template <typename Func>
+		param_type(size_t nw, double xmin, double xmax, Func fw)
+		{
+			const size_t n = nw ? nw : 1;
+			const double delta = (xmax - xmin) / n;
+			prob.reserve(n);
+			for (size_t i = 0; i < n; ++i) {
+				prob.push_back(fw(xmin + (i + 0.5) * delta));
+			}
+			init();
+		}
+
+		std::vector<double> probabilities() const
+		{
+			return prob;
+		}
+
+		friend bool operator==(const param_type &lhs, const param_type &rhs)
+		{
+			return lhs.prob == rhs.prob;
+		}
+		friend bool operator!=(const param_type &lhs, const param_type &rhs)
+		{
+			return !(lhs == rhs);
+		}
+
+	private:
+		friend class alias_distribution;
+
+		// column and alias side by side, one cache line access per sample
+		struct entry
+		{
+			uint64_t threshold; // P(keep column) * 2^64
+			result_type alias;
+		};
+
+		std::vector<double> prob;
+		std::vector<entry> table;
+
+		void init()
+		{
+			if (prob.empty()) {
+				prob.assign(1, 1.0);
+			}
+			const size_t n = prob.size();
+			const double sum = std::accumulate(prob.begin(), prob.end(), 0.0);
+			for (auto &p : prob) {
+				p /= sum;
+			}
+
+			std::vector<double> scaled(n);
+			std::vector<size_t> small, large;
+			small.reserve(n);
+			large.reserve(n);
+			for (size_t i = 0; i < n; ++i) {
+				scaled[i] = prob[i] * n;
+				(scaled[i] < 1.0 ? small : large).push_back(i);
+			}
+
+			table.resize(n);
+			while (!small.empty() && !large.empty()) {
+				const size_t l = small.back(), g = large.back();
+				small.pop_back();
+				table[l] = { to_fixed(scaled[l]), static_cast<result_type>(g) };
+				scaled[g] = (scaled[g] + scaled[l]) - 1.0;
+				if (scaled[g] < 1.0) {
+					large.pop_back();
+					small.push_back(g);
+				}
+			}
+			// leftovers are 1 up to rounding
+			for (auto i : large) {
+				table[i] = { UINT64_MAX, static_cast<result_type>(i) };
+			}
+			for (auto i : small) {
+				table[i] = { UINT64_MAX, static_cast<result_type>(i) };
+			}
+		}
+
+		static uint64_t to_fixed(double q)
+		{
+			const double scaled = q * 18446744073709551616.0; // 2^64
+			return scaled >= 18446744073709551616.0 ? UINT64_MAX : static_cast<uint64_t>(scaled);
+		}
+	};
+
+	alias_distribution() = default;
+	template <typename InputIt>
+	alias_distribution(InputIt first, InputIt last) : par(first, last) {}
+	alias_distribution(std::initializer_list<double> wl) : par(wl) {}
+	template <typename Func>
+	alias_distribution(size_t nw, double xmin, double xmax, Func fw) : par(nw, xmin, xmax, fw) {}
+	explicit alias_distribution(const param_type &p) : par(p) {}
+
+	void reset() {}
+
+	std::vector<double> probabilities() const { return par.probabilities(); }
+	param_type param() const { return par; }
+	void param(const param_type &p) { par = p; }
+	result_type min() const { return 0; }
+	result_type max() const { return static_cast<result_type>(par.prob.size() - 1); }
+
+	template <typename URBG>
+	result_type operator()(URBG &g)
+	{
+		return (*this)(g, par);
+	}
+	template <typename URBG>
+	result_type operator()(URBG &g, const param_type &p)
+	{
+		// the high word of r * n picks the column, the low word is the coin
+		uint64_t coin;
+		const uint64_t column = rand_util::mulhi64(rand_util::word64(g), p.table.size(), coin);
+		const auto &e = p.table[column];
+		return coin < e.threshold ? static_cast<result_type>(column) : e.alias;
+	}
+
+	// bulk sampling
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g)
+	{
+		generate(first, last, g, par);
+	}
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g, const param_type &p)
+	{
+		const uint64_t n = p.table.size();
+		const auto *table = p.table.data();
+		for (; first != last; ++first) {
+			uint64_t coin;
+			const uint64_t column = rand_util::mulhi64(rand_util::word64(g), n, coin);
+			*first = coin < table[column].threshold ? static_cast<result_type>(column) : table[column].alias;
+		}
+	}
+
+	friend bool operator==(const alias_distribution &lhs, const alias_distribution &rhs)
+	{
+		return lhs.par == rhs.par;
+	}
+	friend bool operator!=(const alias_distribution &lhs, const alias_distribution &rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <typename CharT, typename Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits> &os, const alias_distribution &d)
+	{
+		const auto precision = os.precision(std::numeric_limits<double>::max_digits10);
+		const auto prob = d.probabilities();
+		os << prob.size();
+		for (auto p : prob) {
+			os << ' ' << p;
+		}
+		os.precision(precision);
+		return os;
+	}
+	template <typename CharT, typename Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits> &is, alias_distribution &d)
+	{
+		size_t n;
+		if (is >> n) {
+			std::vector<double> prob(n);
+			for (auto &p : prob) {
+				is >> p;
+			}
+			if (is) {
+				d.par = param_type(prob.begin(), prob.end());
+			}
+		}
+		return is;
+	}
+
+private:
+	param_type par;
+};
+
+#endif // ALIAS_DISTRIBUTION_H
@@ -0,0 +1,390 @@
+#ifndef ANY_ENGINE_H
+#define ANY_ENGINE_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+#include "bsd_rand.hpp"
+#include "cmwc_rand.hpp"
+#include "glibc_rand.hpp"
+#include "isaac64_rand.hpp"
+#include "isaac_rand.hpp"
+#include "java_rand.hpp"
+#include "jsf32.hpp"
+#include "jsf64.hpp"
+#include "jsf_avx2.hpp"
+#include "mmix_rand.hpp"
+#include "msvc_rand.hpp"
+#include "mt19937_rand.hpp"
+#include "posix_rand.hpp"
+#include "rand_util.hpp"
+#include "romu_rand.hpp"
+#include "sfc64_rand.hpp"
+#include "sfmt_rand.hpp"
+#include "splitmix64_rand.hpp"
+#include "wyrand_rand.hpp"
+#include "xoroshiro128_rand.hpp"
+#include "xoroshiro64_rand.hpp"
+#include "xoshiro128_rand.hpp"
+#include "xoshiro256_rand.hpp"
+
+// An engine chosen at run time by name, e.g. any_engine("xoshiro256**", seed).
+//
+// The virtual interface works on blocks of 64-bit words, fill() makes one
+// virtual call per block and operator() serves single words from a buffer
+// refilled the same way. A word is the result of a full 64-bit engine, two
+// results of a full 32-bit engine (the first one in the low half), or
+// rand_util::word64 for the others. Streaming an any_engine writes its
+// name, the engine state and the buffered words, so reading it back gives
+// the same engine at the same position.
+
+namespace any_engine_detail
+{
+	class model_base
+	{
+	public:
+		virtual ~model_base() = default;
+		virtual std::unique_ptr<model_base> clone() const = 0;
+		virtual void seed(uint64_t value) = 0;
+		virtual void fill(uint64_t *out, size_t n) = 0;
+		virtual void discard(unsigned long long z) = 0;
+		virtual bool equal(const model_base &other) const = 0;
+		virtual void write(std::ostream &os) const = 0;
+		virtual void read(std::istream &is) = 0;
+	};
+
+	template <typename Engine, typename = void>
+	struct has_generate : std::false_type {};
+	template <typename Engine>
+	struct has_generate<Engine, decltype(std::declval<Engine &>().generate(
+		std::declval<typename Engine::result_type *>(), std::declval<typename Engine::result_type *>()))> : std::true_type {};
+
+	template <typename Engine>
+	class model final : public model_base
+	{
+		using T = typename Engine::result_type;
+		static constexpr unsigned bits = rand_util::engine_bits<Engine>();
+
+	public:
+		explicit model(uint64_t value) : eng(value) {}
+
+		std::unique_ptr<model_base> clone() const override
+		{
+			return std::make_unique<model>(*this);
+		}
+		void seed(uint64_t value) override
+		{
+			eng.seed(value);
+		}
+		void fill(uint64_t *out, size_t n) override
+		{
+			if constexpr (bits == 64) {
+				if constexpr (has_generate<Engine>::value && std::is_same<T, uint64_t>::value) {
+					eng.generate(out, out + n);
+				} else {
+					for (size_t i = 0; i < n; ++i) {
+						out[i] = static_cast<uint64_t>(eng());
+					}
+				}
+			} else if constexpr (bits == 32) {
+				if constexpr (has_generate<Engine>::value) {
+					enum : size_t { CHUNK = 512 };
+					T tmp[2 * CHUNK];
+					while (n) {
+						const size_t m = n < CHUNK ? n : CHUNK;
+						eng.generate(tmp, tmp + 2 * m);
+						for (size_t i = 0; i < m; ++i) {
+							out[i] = static_cast<uint32_t>(tmp[2 * i]) | static_cast<uint64_t>(tmp[2 * i + 1]) << 32;
+						}
+						out += m;
+						n -= m;
+					}
+				} else {
+					for (size_t i = 0; i < n; ++i) {
+						const uint64_t lo = static_cast<uint32_t>(eng());
+						out[i] = lo | static_cast<uint64_t>(static_cast<uint32_t>(eng())) << 32;
+					}
+				}
+			} else {
+				for (size_t i = 0; i < n; ++i) {
+					out[i] = rand_util::word64(eng);
+				}
+			}
+		}
+		void discard(unsigned long long z) override
+		{
+			if constexpr (bits > 0) {
+				eng.discard(z * ((64 + bits - 1) / bits)); // engine results per word
+			} else {
+				while (z--) {
+					rand_util::word64(eng);
+				}
+			}
+		}
+		bool equal(const model_base &other) const override
+		{
+			const model *o = dynamic_cast<const model *>(&other);
+			return o && o->eng == eng;
+		}
+		void write(std::ostream &os) const override
+		{
+			os << eng;
+		}
+		void read(std::istream &is) override
+		{
+			is >> std::ws >> eng; // the std LCG extractors do not skip whitespace
+		}
+
+	private:
+		Engine eng;
+	};
+
+	using factory = std::unique_ptr<model_base> (*)(uint64_t);
+
+	template <typename Engine>
+	std::unique_ptr<model_base> make(uint64_t value)
+	{
+		return std::make_unique<model<Engine>>(value);
+	}
+
+	inline std::map<std::string, factory>& registry()
+	{
+		static std::map<std::string, factory> engines = {
+			{ "bsd", make<bsd_engine> },
+			{ "cmwc", make<cmwc_engine> },
+			{ "cmwc256", make<cmwc256_engine> },
+			{ "cmwc8", make<cmwc8_engine> },
+			{ "dsfmt19937", make<dsfmt19937_engine> },
+			{ "glibc", make<glibc_engine> },
+			{ "glibc_random", make<glibc_random_engine> },
+			{ "isaac", make<isaac_engine> },
+			{ "isaac64", make<isaac64_engine> },
+			{ "java", make<java_engine> },
+			{ "java_splittable", make<java_splittable_engine> },
+			{ "jsf32", make<jsf32_engine> },
+			{ "jsf32x8", make<jsf32x8_engine> },
+			{ "jsf64", make<jsf64_engine> },
+			{ "jsf64x4", make<jsf64x4_engine> },
+			{ "mmix", make<mmix_engine> },
+			{ "msvc", make<msvc_engine> },
+			{ "mt19937", make<mt19937_engine> },
+			{ "posix", make<posix_engine> },
+			{ "romuduojr", make<romu_duo_jr_engine> },
+			{ "romutrio", make<romu_trio_engine> },
+			{ "sfc64", make<sfc64_engine> },
+			{ "sfmt19937", make<sfmt19937_engine> },
+			{ "splitmix64", make<splitmix64_engine> },
+			{ "wyrand", make<wyrand_engine> },
+			{ "xoroshiro64**", make<xoroshiro64_engine> },
+			{ "xoroshiro128+", make<xoroshiro128plus_engine> },
+			{ "xoroshiro128++", make<xoroshiro128plusplus_engine> },
+			{ "xoroshiro128**", make<xoroshiro128_engine> },
+			{ "xoshiro128**", make<xoshiro128_engine> },
+			{ "xoshiro256+", make<xoshiro256plus_engine> },
+			{ "xoshiro256++", make<xoshiro256plusplus_engine> },
+			{ "xoshiro256**", make<xoshiro256_engine> },
+		};
+		return engines;
+	}
+}
+
+class any_engine
+{
+public:
+	using result_type = uint64_t;
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	static constexpr result_type default_seed = 1;
+
+	// the built-in engines are registered under the names of their algorithms,
+	// register more before any_engine is used from several threads
+	template <typename Engine>
+	static bool register_engine(const std::string &name)
+	{
+		return any_engine_detail::registry().emplace(name, any_engine_detail::make<Engine>).second;
+	}
+	static bool contains(const std::string &name)
+	{
+		return any_engine_detail::registry().count(name) != 0;
+	}
+	static std::vector<std::string> names()
+	{
+		std::vector<std::string> result;
+		for (auto &entry : any_engine_detail::registry()) {
+			result.push_back(entry.first);
+		}
+		return result;
+	}
+
+	any_engine() : any_engine("xoshiro256**") {}
+	// throws std::invalid_argument for an unknown name
+	explicit any_engine(const std::string &name, result_type value = default_seed)
+		: engine_name(name), model(create(name, value))
+	{
+	}
+	any_engine(const any_engine &other)
+		: engine_name(other.engine_name), model(other.model->clone()), pos(other.pos)
+	{
+		std::copy(other.buf + pos, other.buf + BUFFER, buf + pos);
+	}
+	// the source is left as a new engine of the same algorithm, default seeded
+	any_engine(any_engine &&other)
+		: engine_name(other.engine_name), model(std::exchange(other.model, create(other.engine_name, default_seed))),
+		pos(std::exchange(other.pos, BUFFER))
+	{
+		std::copy(other.buf + pos, other.buf + BUFFER, buf + pos);
+	}
+	any_engine& operator=(any_engine other)
+	{
+		std::swap(engine_name, other.engine_name);
+		std::swap(model, other.model);
+		std::swap(buf, other.buf);
+		std::swap(pos, other.pos);
+		return *this;
+	}
+
+	const std::string& name() const { return engine_name; }
+
+	void seed(result_type value = default_seed)
+	{
+		model->seed(value);
+		pos = BUFFER;
+	}
+	result_type operator()()
+	{
+		if (pos == BUFFER) {
+			model->fill(buf, BUFFER);
+			pos = 0;
+		}
+		return buf[pos++];
+	}
+	// bulk output, same values as repeated operator()
+	void fill(result_type *first, result_type *last)
+	{
+		for (; pos < BUFFER && first != last; ++first) {
+			*first = buf[pos++];
+		}
+		if (first != last) {
+			model->fill(first, static_cast<size_t>(last - first));
+		}
+	}
+#if __cplusplus >= 202002L && __has_include(<span>)
+	void fill(std::span<result_type> out)
+	{
+		fill(out.data(), out.data() + out.size());
+	}
+#endif
+	void discard(unsigned long long z)
+	{
+		for (; pos < BUFFER && z; --z) {
+			++pos;
+		}
+		if (z) {
+			model->discard(z);
+		}
+	}
+
+	friend bool operator==(const any_engine &, const any_engine &);
+	friend std::ostream& operator<<(std::ostream &, const any_engine &);
+	friend std::istream& operator>>(std::istream &, any_engine &);
+
+private:
+	enum : unsigned { BUFFER = 256 };
+
+	static std::unique_ptr<any_engine_detail::model_base> create(const std::string &name, result_type value)
+	{
+		const auto &engines = any_engine_detail::registry();
+		const auto it = engines.find(name);
+		if (it == engines.end()) {
+			throw std::invalid_argument("any_engine: unknown engine " + name);
+		}
+		return it->second(value);
+	}
+
+	std::string engine_name;
+	std::unique_ptr<any_engine_detail::model_base> model;
+	result_type buf[BUFFER];
+	unsigned pos = BUFFER;
+};
+
+// equal when both produce the same words from now on, however many of them are buffered
+bool operator==(const any_engine &lhs, const any_engine &rhs)
+{
+	if (lhs.engine_name != rhs.engine_name) {
+		return false;
+	}
+	const any_engine &a = lhs.pos >= rhs.pos ? lhs : rhs; // fewer buffered words
+	const any_engine &b = lhs.pos >= rhs.pos ? rhs : lhs;
+	const unsigned ka = any_engine::BUFFER - a.pos, kb = any_engine::BUFFER - b.pos;
+	if (!std::equal(a.buf + a.pos, a.buf + any_engine::BUFFER, b.buf + b.pos)) {
+		return false;
+	}
+	if (ka == kb) {
+		return a.model->equal(*b.model);
+	}
+	uint64_t ahead[any_engine::BUFFER];
+	const auto model = a.model->clone();
+	model->fill(ahead, kb - ka);
+	return std::equal(ahead, ahead + (kb - ka), b.buf + b.pos + ka) && model->equal(*b.model);
+}
+bool operator!=(const any_engine &lhs, const any_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const any_engine &eng)
+{
+	os << eng.engine_name << ' ';
+	eng.model->write(os);
+	os << ' ' << any_engine::BUFFER - eng.pos;
+	for (unsigned i = eng.pos; i < any_engine::BUFFER; ++i) {
+		os << ' ' << eng.buf[i];
+	}
+	return os;
+}
+std::istream& operator>>(std::istream &is, any_engine &eng)
+{
+	std::string name;
+	unsigned count = 0;
+	if (!(is >> name)) {
+		return is;
+	}
+	const auto &engines = any_engine_detail::registry();
+	const auto it = engines.find(name);
+	if (it == engines.end()) {
+		is.setstate(std::ios_base::failbit);
+		return is;
+	}
+	auto model = it->second(any_engine::default_seed);
+	model->read(is);
+	if (!(is >> count) || count > any_engine::BUFFER) {
+		is.setstate(std::ios_base::failbit);
+		return is;
+	}
+	uint64_t buf[any_engine::BUFFER];
+	const unsigned pos = any_engine::BUFFER - count;
+	for (unsigned i = pos; i < any_engine::BUFFER; ++i) {
+		is >> buf[i];
+	}
+	if (is) {
+		eng.engine_name = name;
+		eng.model = std::move(model);
+		std::copy(buf + pos, buf + any_engine::BUFFER, eng.buf + pos);
+		eng.pos = pos;
+	}
+	return is;
+}
+
+#endif // ANY_ENGINE_H
@@ -0,0 +1,82 @@
+#ifndef ATOMIC_SPLITMIX64_RANDOM_H
+#define ATOMIC_SPLITMIX64_RANDOM_H
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include "splitmix64_rand.hpp"
+
+// SplitMix64 shared between threads without a lock: the state is a Weyl
+// counter, so a draw is one fetch_add followed by the stateless mixer.
+// A single thread sees exactly the splitmix64_engine sequence.
+
+class atomic_splitmix64_engine // SplitMix64, wait-free
+{
+public:
+	using result_type = uint64_t;
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	static constexpr result_type default_seed = 1;
+
+	explicit atomic_splitmix64_engine(result_type value = default_seed)
+	{
+		seed(value);
+	}
+	atomic_splitmix64_engine(const atomic_splitmix64_engine &other) : x(other.x.load()) {}
+	atomic_splitmix64_engine& operator=(const atomic_splitmix64_engine &other)
+	{
+		x.store(other.x.load());
+		return *this;
+	}
+	void seed(result_type value = default_seed)
+	{
+		x.store(value);
+	}
+	result_type operator()()
+	{
+		return splitmix64_engine{ x.fetch_add(GOLDEN_GAMMA, std::memory_order_relaxed) }();
+	}
+	void discard(unsigned long long z)
+	{
+		x.fetch_add(z * GOLDEN_GAMMA, std::memory_order_relaxed);
+	}
+	// claims the next k values with one atomic operation,
+	// the returned engine produces exactly those k values
+	splitmix64_engine reserve(unsigned long long k)
+	{
+		return splitmix64_engine{ x.fetch_add(k * GOLDEN_GAMMA, std::memory_order_relaxed) };
+	}
+
+	friend bool operator==(const atomic_splitmix64_engine &, const atomic_splitmix64_engine &);
+	friend std::ostream& operator<<(std::ostream &, const atomic_splitmix64_engine &);
+	friend std::istream& operator>>(std::istream &, atomic_splitmix64_engine &);
+
+private:
+	enum : uint64_t { GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL };
+
+	alignas(64) std::atomic<uint64_t> x; // own cache line
+};
+
+bool operator==(const atomic_splitmix64_engine &lhs, const atomic_splitmix64_engine &rhs)
+{
+	return lhs.x.load() == rhs.x.load();
+}
+bool operator!=(const atomic_splitmix64_engine &lhs, const atomic_splitmix64_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const atomic_splitmix64_engine &eng)
+{
+	return os << eng.x.load();
+}
+std::istream& operator>>(std::istream &is, atomic_splitmix64_engine &eng)
+{
+	uint64_t value;
+	if (is >> value) {
+		eng.x.store(value);
+	}
+	return is;
+}
+
+#endif // ATOMIC_SPLITMIX64_RANDOM_H
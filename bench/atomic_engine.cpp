@@ -0,0 +1,78 @@
+// Shared-generator throughput: wait-free atomic SplitMix64 (per draw and with
+// block reservation) against a mutex-wrapped engine and thread-local engines.
+// g++ -std=c++17 -O2 -pthread -I.. atomic_engine.cpp -o atomic_engine
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../atomic_splitmix64_rand.hpp"
+#include "../mmix_rand.hpp"
+
+template <typename Body>
+double run(unsigned threads, size_t draws, Body body)
+{
+	std::vector<std::thread> pool;
+	std::atomic<uint64_t> sink{ 0 };
+	const auto t0 = std::chrono::steady_clock::now();
+	for (unsigned t = 0; t < threads; ++t) {
+		pool.emplace_back([&, t]() { sink += body(t, draws); });
+	}
+	for (auto &t : pool) {
+		t.join();
+	}
+	const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+	return threads * draws / dt.count() / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t draws = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 1 << 24;
+	const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+	const unsigned block = 256;
+
+	std::printf("%8s %12s %12s %12s %12s   (Mdraws/s)\n", "threads", "atomic", "reserve", "mutex", "thread_local");
+	for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+		atomic_splitmix64_engine shared;
+		const double atomic = run(threads, draws, [&](unsigned, size_t n) {
+			uint64_t s = 0;
+			while (n--) {
+				s += shared();
+			}
+			return s;
+		});
+		const double reserve = run(threads, draws, [&](unsigned, size_t n) {
+			uint64_t s = 0;
+			for (size_t i = 0; i < n; i += block) {
+				auto claim = shared.reserve(block);
+				for (unsigned j = 0; j < block; ++j) {
+					s += claim();
+				}
+			}
+			return s;
+		});
+		mmix_engine locked_eng;
+		std::mutex lock;
+		const double mutex = run(threads, draws, [&](unsigned, size_t n) {
+			uint64_t s = 0;
+			while (n--) {
+				std::lock_guard<std::mutex> guard(lock);
+				s += locked_eng();
+			}
+			return s;
+		});
+		const double local = run(threads, draws, [&](unsigned t, size_t n) {
+			thread_local splitmix64_engine eng;
+			eng.seed(t);
+			uint64_t s = 0;
+			while (n--) {
+				s += eng();
+			}
+			return s;
+		});
+		std::printf("%8u %12.1f %12.1f %12.1f %12.1f\n", threads, atomic, reserve, mutex, local);
+	}
+}
@@ -0,0 +1,41 @@
+// Scaling of parallel_generate from 1 to N threads.
+// g++ -std=c++17 -O2 -pthread -I.. parallel_generate.cpp -o parallel_generate
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../parallel_generate.hpp"
+#include "../xoshiro256_rand.hpp"
+
+template <typename Engine>
+void scaling(const char *name, size_t n, unsigned max_threads)
+{
+	std::vector<typename Engine::result_type> reference(n), out(n);
+	Engine ref_eng;
+	parallel_generate(ref_eng, reference.begin(), reference.end(), 1);
+
+	for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+		Engine eng;
+		const auto t0 = std::chrono::steady_clock::now();
+		parallel_generate(eng, out.begin(), out.end(), threads);
+		const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+		const double gbs = n * sizeof(out[0]) / dt.count() / 1e9;
+		std::printf("%-12s %3u threads %8.2f GB/s %s\n", name, threads, gbs,
+			out == reference && eng == ref_eng ? "identical" : "MISMATCH");
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 1ull << 26;
+	const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+	scaling<splitmix64_engine>("splitmix64", n, max_threads);
+	scaling<mmix_engine>("mmix", n, max_threads);
+	scaling<posix_engine>("posix", n, max_threads);
+	scaling<xoshiro256_engine>("xoshiro256", n, max_threads);
+}
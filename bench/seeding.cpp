@@ -0,0 +1,67 @@
+// Cost of seeding one engine: seed() in a loop, seed_many() and derive_many().
+// g++ -std=c++17 -O2 -march=native -I.. seeding.cpp -o seeding
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "../cmwc_rand.hpp"
+#include "../isaac64_rand.hpp"
+#include "../isaac_rand.hpp"
+#include "../jsf64.hpp"
+#include "../mt19937_rand.hpp"
+#include "../seed_many.hpp"
+#include "../sfc64_rand.hpp"
+#include "../sfmt_rand.hpp"
+#include "../xoshiro256_rand.hpp"
+
+template <typename F>
+double ns_per_engine(size_t n, unsigned rounds, F f)
+{
+	double best = 1e300;
+	for (unsigned r = 0; r < rounds; ++r) {
+		const auto t0 = std::chrono::steady_clock::now();
+		f();
+		const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+		best = std::min(best, dt.count() / n * 1e9);
+	}
+	return best;
+}
+
+template <typename Engine>
+void seeding(const char *name, size_t n)
+{
+	using key_type = typename Engine::result_type;
+	std::vector<Engine> engines(n), reference(n);
+	std::vector<key_type> keys(n);
+	for (size_t i = 0; i < n; ++i) {
+		keys[i] = static_cast<key_type>(i * 0x9E3779B97F4A7C15ULL);
+	}
+	const Engine prototype(12345);
+	Engine *first = engines.data(), *last = first + n;
+
+	const double loop = ns_per_engine(n, 5, [&]() {
+		for (size_t i = 0; i < n; ++i) {
+			reference[i].seed(keys[i]);
+		}
+	});
+	const double many = ns_per_engine(n, 5, [&]() { seed_many(first, last, keys.data()); });
+	const bool same = engines == reference;
+	const double derived = ns_per_engine(n, 5, [&]() { derive_many(first, last, prototype, keys.data()); });
+	std::printf("%-12s seed %9.1f ns   seed_many %9.1f ns (%s)   derive_many %9.1f ns\n", name, loop, many,
+		same ? "identical" : "MISMATCH", derived);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 1 << 12;
+
+	seeding<isaac_engine>("isaac", n);
+	seeding<isaac64_engine>("isaac64", n);
+	seeding<cmwc_engine>("cmwc", n);
+	seeding<mt19937_engine>("mt19937", n);
+	seeding<sfmt19937_engine>("sfmt19937", n);
+	seeding<jsf64_engine>("jsf64", n);
+	seeding<sfc64_engine>("sfc64", n);
+	seeding<xoshiro256_engine>("xoshiro256", n);
+}
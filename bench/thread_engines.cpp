@@ -0,0 +1,83 @@
+// Per-thread engines from 1 to N threads: engines packed in a std::vector
+// built by the main thread against thread_engines, through local() and at(t).
+// g++ -std=c++17 -O2 -pthread -I.. thread_engines.cpp -o thread_engines
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../isaac64_rand.hpp"
+#include "../thread_engines.hpp"
+#include "../xoshiro256_rand.hpp"
+
+template <typename Body>
+double run(unsigned threads, size_t draws, Body body)
+{
+	std::vector<std::thread> pool;
+	std::atomic<uint64_t> sink{ 0 };
+	const auto t0 = std::chrono::steady_clock::now();
+	for (unsigned t = 0; t < threads; ++t) {
+		pool.emplace_back([&, t]() { sink += body(t, draws); });
+	}
+	for (auto &t : pool) {
+		t.join();
+	}
+	const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+	return threads * draws / dt.count() / 1e6;
+}
+
+// draws into a buffer, as a consumer would; the stores keep the engine state in memory
+template <typename Engine>
+uint64_t fill(Engine &eng, size_t n)
+{
+	uint64_t buf[256], s = 0;
+	for (size_t i = 0; i < n; i += 256) {
+		for (auto &x : buf) {
+			x = eng();
+		}
+		s += buf[0] ^ buf[255];
+	}
+	return s;
+}
+
+template <typename Engine>
+void scaling(const char *name, size_t draws, unsigned max_threads)
+{
+	// powers of 2, then all hardware threads
+	std::vector<unsigned> counts;
+	for (unsigned threads = 1; threads < max_threads; threads *= 2) {
+		counts.push_back(threads);
+	}
+	counts.push_back(max_threads);
+	for (unsigned threads : counts) {
+		std::vector<Engine> packed;
+		for (unsigned t = 0; t < threads; ++t) {
+			packed.emplace_back(t);
+		}
+		const double vector = run(threads, draws, [&](unsigned t, size_t n) {
+			return fill(packed[t], n);
+		});
+		thread_engines<Engine> by_thread(threads);
+		const double local = run(threads, draws, [&](unsigned, size_t n) {
+			return fill(by_thread.local(), n);
+		});
+		thread_engines<Engine> by_index(threads);
+		const double at = run(threads, draws, [&](unsigned t, size_t n) {
+			return fill(by_index.at(t), n);
+		});
+		std::printf("%-10s %8u %12.1f %12.1f %12.1f\n", name, threads, vector, local, at);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t draws = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 1 << 24;
+	const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+	std::printf("%-10s %8s %12s %12s %12s   (Mdraws/s)\n", "engine", "threads", "vector", "local()", "at(t)");
+	scaling<xoshiro256_engine>("xoshiro256", draws, max_threads);
+	scaling<isaac64_engine>("isaac64", draws, max_threads);
+}
@@ -0,0 +1,49 @@
+// Single-thread throughput of the 64-bit engines and the light-weight ones.
+// g++ -std=c++17 -O2 -I.. throughput.cpp -o throughput
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include "../any_engine.hpp"
+#include "../isaac64_rand.hpp"
+#include "../jsf64.hpp"
+#include "../mmix_rand.hpp"
+#include "../romu_rand.hpp"
+#include "../sfc64_rand.hpp"
+#include "../splitmix64_rand.hpp"
+#include "../wyrand_rand.hpp"
+#include "../xoroshiro128_rand.hpp"
+#include "../xoshiro256_rand.hpp"
+
+template <typename Engine>
+void throughput(const char *name, size_t draws)
+{
+	Engine eng;
+	uint64_t sink = 0;
+	const auto t0 = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < draws; ++i) {
+		sink += eng();
+	}
+	const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+	std::printf("%-16s %8.3f ns/draw %8.2f GB/s   (%016llx)\n", name, dt.count() / draws * 1e9,
+		draws * sizeof(typename Engine::result_type) / dt.count() / 1e9, static_cast<unsigned long long>(sink));
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t draws = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 1 << 28;
+
+	throughput<wyrand_engine>("wyrand", draws);
+	throughput<romu_duo_jr_engine>("RomuDuoJr", draws);
+	throughput<romu_trio_engine>("RomuTrio", draws);
+	throughput<sfc64_engine>("sfc64", draws);
+	throughput<splitmix64_engine>("SplitMix64", draws);
+	throughput<xoroshiro128plusplus_engine>("xoroshiro128++", draws);
+	throughput<xoroshiro128_engine>("xoroshiro128**", draws);
+	throughput<xoshiro256plusplus_engine>("xoshiro256++", draws);
+	throughput<xoshiro256_engine>("xoshiro256**", draws);
+	throughput<any_engine>("any xoshiro256**", draws);
+	throughput<jsf64_engine>("jsf64", draws);
+	throughput<mmix_engine>("mmix", draws);
+	throughput<isaac64_engine>("ISAAC64", draws);
+}
@@ -0,0 +1,319 @@
+#ifndef CHECKPOINT_INDEX_H
+#define CHECKPOINT_INDEX_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CHECKPOINT_INDEX_MMAP
+#endif
+
+// Random access into the output of engines without a skip-ahead (jsf64,
+// isaac, cmwc...). checkpoint_recorder<Engine> draws through an engine and
+// appends its state to an index file every `stride` draws, starting with the
+// state it was given; checkpoint_index<Engine> maps that file and serves the
+// state at any draw number from the nearest earlier snapshot plus at most
+// stride - 1 discarded draws:
+//
+//   {
+//       checkpoint_recorder<jsf64_engine> rec("run.ckpt", "jsf64", jsf64_engine(seed), 1 << 20);
+//       simulate(rec);
+//   }
+//   checkpoint_index<jsf64_engine> index("run.ckpt", "jsf64");
+//   jsf64_engine eng = index.seek(123456789); // as after 123456789 draws
+//
+// The file is a 128-byte header followed by the engine objects themselves, each
+// in a 64-byte aligned record, so snapshots are used in place in the mapping.
+// That representation is only meaningful to the same engine type built with
+// the same ABI: the header records a format version, the byte order, the
+// engine name and the object size and alignment, and opening a file that does
+// not match throws std::runtime_error.
+
+namespace checkpoint_detail
+{
+	enum : uint32_t { VERSION = 1, BYTE_ORDER_MARK = 0x01020304 };
+	enum : size_t { ALIGN = 64, NAME = 48 };
+
+	struct header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t byte_order;
+		char name[NAME];
+		uint64_t state_size;
+		uint64_t state_align;
+		uint64_t record_size;
+		uint64_t stride;
+		uint64_t count;
+		uint64_t reserved[3];
+	};
+	static_assert(sizeof(header) == 128, "checkpoint header layout");
+
+	constexpr char MAGIC[8] = { 'R', 'N', 'G', 'C', 'K', 'P', 'T', '\0' };
+
+	constexpr uint64_t record_size(size_t state_size)
+	{
+		return (state_size + ALIGN - 1) / ALIGN * ALIGN;
+	}
+
+	inline header make_header(const std::string &name, size_t state_size, size_t state_align, uint64_t stride)
+	{
+		if (name.size() >= NAME) {
+			throw std::invalid_argument("checkpoint: engine name too long");
+		}
+		header h = {};
+		std::memcpy(h.magic, MAGIC, sizeof MAGIC);
+		h.version = VERSION;
+		h.byte_order = BYTE_ORDER_MARK;
+		std::memcpy(h.name, name.data(), name.size());
+		h.state_size = state_size;
+		h.state_align = state_align;
+		h.record_size = record_size(state_size);
+		h.stride = stride;
+		return h;
+	}
+
+	// read-only view of a whole file, mapped where possible
+	class mapping
+	{
+	public:
+		explicit mapping(const std::string &path)
+		{
+#if defined(CHECKPOINT_INDEX_MMAP)
+			const int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				throw std::runtime_error("checkpoint: cannot open " + path);
+			}
+			struct stat st;
+			if (fstat(fd, &st) != 0) {
+				::close(fd);
+				throw std::runtime_error("checkpoint: cannot stat " + path);
+			}
+			length = static_cast<size_t>(st.st_size);
+			void *p = length ? mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+			::close(fd);
+			if (p == MAP_FAILED) {
+				throw std::runtime_error("checkpoint: cannot map " + path);
+			}
+			base = static_cast<const unsigned char *>(p);
+#else
+			std::FILE *f = std::fopen(path.c_str(), "rb");
+			if (!f) {
+				throw std::runtime_error("checkpoint: cannot open " + path);
+			}
+			std::fseek(f, 0, SEEK_END);
+			length = static_cast<size_t>(std::ftell(f));
+			std::fseek(f, 0, SEEK_SET);
+			unsigned char *p = static_cast<unsigned char *>(::operator new(length ? length : 1, std::align_val_t(ALIGN)));
+			const bool ok = std::fread(p, 1, length, f) == length;
+			std::fclose(f);
+			if (!ok) {
+				::operator delete(p, std::align_val_t(ALIGN));
+				throw std::runtime_error("checkpoint: cannot read " + path);
+			}
+			base = p;
+#endif
+		}
+		~mapping()
+		{
+#if defined(CHECKPOINT_INDEX_MMAP)
+			munmap(const_cast<unsigned char *>(base), length);
+#else
+			::operator delete(const_cast<unsigned char *>(base), std::align_val_t(ALIGN));
+#endif
+		}
+		mapping(const mapping &) = delete;
+		mapping& operator=(const mapping &) = delete;
+
+		const unsigned char* data() const { return base; }
+		size_t size() const { return length; }
+
+	private:
+		const unsigned char *base = nullptr;
+		size_t length = 0;
+	};
+}
+
+template <typename Engine>
+class checkpoint_recorder
+{
+	static_assert(std::is_trivially_copyable<Engine>::value, "checkpoints store the engine object as is");
+
+public:
+	using engine_type = Engine;
+	using result_type = typename Engine::result_type;
+
+	static constexpr result_type min() { return Engine::min(); }
+	static constexpr result_type max() { return Engine::max(); }
+
+	checkpoint_recorder(const std::string &path, const std::string &name, const Engine &e, uint64_t stride)
+		: eng(e), head(checkpoint_detail::make_header(name, sizeof(Engine), alignof(Engine), stride)), until(stride)
+	{
+		if (stride == 0) {
+			throw std::invalid_argument("checkpoint: stride must be positive");
+		}
+		file = std::fopen(path.c_str(), "wb");
+		if (!file) {
+			throw std::runtime_error("checkpoint: cannot create " + path);
+		}
+		write(&head, sizeof head);
+		snapshot();
+	}
+	~checkpoint_recorder()
+	{
+		try {
+			close();
+		} catch (...) {
+		}
+	}
+	checkpoint_recorder(const checkpoint_recorder &) = delete;
+	checkpoint_recorder& operator=(const checkpoint_recorder &) = delete;
+
+	result_type operator()()
+	{
+		const result_type result = eng();
+		if (--until == 0) {
+			snapshot();
+		}
+		return result;
+	}
+	void generate(result_type *first, result_type *last)
+	{
+		while (first != last) {
+			const size_t n = static_cast<size_t>(std::min<uint64_t>(until, static_cast<uint64_t>(last - first)));
+			for (size_t i = 0; i < n; ++i) {
+				first[i] = eng();
+			}
+			first += n;
+			if ((until -= n) == 0) {
+				snapshot();
+			}
+		}
+	}
+	void discard(unsigned long long z)
+	{
+		while (z) {
+			const uint64_t n = std::min<uint64_t>(until, z);
+			eng.discard(n);
+			z -= n;
+			if ((until -= n) == 0) {
+				snapshot();
+			}
+		}
+	}
+
+	// draws since the initial state
+	uint64_t position() const { return head.count * head.stride - until; }
+	const Engine& engine() const { return eng; }
+
+	// writes the final snapshot count; the recorder must not be used afterwards
+	void close()
+	{
+		if (!file) {
+			return;
+		}
+		const bool ok = std::fflush(file) == 0 && std::fseek(file, 0, SEEK_SET) == 0
+			&& std::fwrite(&head, sizeof head, 1, file) == 1;
+		const bool closed = std::fclose(file) == 0;
+		file = nullptr;
+		if (!ok || !closed) {
+			throw std::runtime_error("checkpoint: cannot finish the index file");
+		}
+	}
+
+private:
+	Engine eng;
+	checkpoint_detail::header head;
+	uint64_t until; // draws until the next snapshot
+	std::FILE *file = nullptr;
+
+	void write(const void *p, size_t size)
+	{
+		if (std::fwrite(p, 1, size, file) != size) {
+			throw std::runtime_error("checkpoint: write failed");
+		}
+	}
+	void snapshot()
+	{
+		alignas(checkpoint_detail::ALIGN) unsigned char record[checkpoint_detail::record_size(sizeof(Engine))] = {};
+		std::memcpy(record, &eng, sizeof(Engine));
+		write(record, sizeof record);
+		++head.count;
+		until = head.stride;
+	}
+};
+
+template <typename Engine>
+class checkpoint_index
+{
+	static_assert(std::is_trivially_copyable<Engine>::value, "checkpoints store the engine object as is");
+	static_assert(alignof(Engine) <= checkpoint_detail::ALIGN, "records are 64-byte aligned");
+
+public:
+	checkpoint_index(const std::string &path, const std::string &name) : file(path)
+	{
+		using namespace checkpoint_detail;
+		const header expected = make_header(name, sizeof(Engine), alignof(Engine), 1);
+		if (file.size() < sizeof(header)) {
+			throw std::runtime_error("checkpoint: " + path + " is too short");
+		}
+		std::memcpy(&head, file.data(), sizeof head);
+		if (std::memcmp(head.magic, MAGIC, sizeof MAGIC) != 0) {
+			throw std::runtime_error("checkpoint: " + path + " is not a checkpoint index");
+		}
+		if (head.version != VERSION) {
+			throw std::runtime_error("checkpoint: " + path + " has an unsupported version");
+		}
+		if (head.byte_order != BYTE_ORDER_MARK) {
+			throw std::runtime_error("checkpoint: " + path + " was written with another byte order");
+		}
+		if (std::memcmp(head.name, expected.name, NAME) != 0 || head.state_size != expected.state_size
+			|| head.state_align != expected.state_align || head.record_size != expected.record_size) {
+			throw std::runtime_error("checkpoint: " + path + " holds another engine or ABI");
+		}
+		if (head.stride == 0 || head.count == 0 || (file.size() - sizeof(header)) / head.record_size < head.count) {
+			throw std::runtime_error("checkpoint: " + path + " is truncated or was not closed");
+		}
+	}
+
+	uint64_t stride() const { return head.stride; }
+	uint64_t size() const { return head.count; }
+	std::string name() const { return std::string(head.name); }
+
+	// the state after k * stride() draws, in place in the mapping
+	const Engine& snapshot(uint64_t k) const
+	{
+		if (k >= head.count) {
+			throw std::out_of_range("checkpoint: no such snapshot");
+		}
+		return *reinterpret_cast<const Engine *>(file.data() + sizeof(checkpoint_detail::header) + k * head.record_size);
+	}
+
+	// the state after n draws; positions past the last snapshot are reached by discarding from it
+	Engine seek(uint64_t n) const
+	{
+		const uint64_t k = std::min<uint64_t>(n / head.stride, head.count - 1);
+		Engine eng = snapshot(k);
+		eng.discard(n - k * head.stride);
+		return eng;
+	}
+	void seek(Engine &eng, uint64_t n) const
+	{
+		eng = seek(n);
+	}
+
+private:
+	checkpoint_detail::mapping file;
+	checkpoint_detail::header head;
+};
+
+#endif // CHECKPOINT_INDEX_H
@@ -1,13 +1,51 @@
 #ifndef CMWC_RANDOM_H
 #define CMWC_RANDOM_H
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <iosfwd>
 #include <limits>
-#include <random>
 
-class cmwc_engine // http://en.wikipedia.org/wiki/Complementary-multiply-with-carry
+namespace cmwc_detail
 {
+	enum : uint32_t { LCG_A = 0x343FD, LCG_C = 0x269EC3 };
+	enum : size_t { SEED_LANES = 32 };
+
+	// SEED_LANES steps of the seeding LCG at once: x -> A' x + C'
+	constexpr uint32_t lcg_a_lanes()
+	{
+		uint32_t a = 1;
+		for (size_t k = 0; k < SEED_LANES; ++k) {
+			a *= LCG_A;
+		}
+		return a;
+	}
+	constexpr uint32_t lcg_c_lanes()
+	{
+		uint32_t c = 0;
+		for (size_t k = 0; k < SEED_LANES; ++k) {
+			c = LCG_A * c + LCG_C;
+		}
+		return c;
+	}
+}
+
+// http://en.wikipedia.org/wiki/Complementary-multiply-with-carry
+//
+// x[n] = (b - 1) - (A x[n - R] + c[n - 1]) mod b, b = 2^32 - 1, from a lag-R
+// table of 4 R bytes. The parameter sets below have p = A b^R + 1 prime and b
+// a primitive root mod p, so the period is p - 1:
+//  - cmwc8_engine:    R = 8,    A = 4294967054, 40 bytes, period about 2^288
+//  - cmwc256_engine:  R = 256,  A = 987662290,  1 KiB,    period about 2^8222 (Marsaglia)
+//  - cmwc_engine:     R = 4096, A = 18782,      16 KiB,   period about 2^131104 (Marsaglia)
+// CMax bounds the seeded carry, below A for the first two; cmwc_engine keeps
+// the limit it always had.
+template <uint32_t R, uint32_t A, uint32_t CMax>
+class basic_cmwc_engine
+{
+	static_assert(R >= 1 && (R & (R - 1)) == 0, "the lag must be a power of 2");
+
 public:
 	using result_type = uint32_t;
 
@@ -15,69 +53,132 @@ public:
 	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
 	static constexpr result_type default_seed = 1;
 
-	explicit cmwc_engine(result_type s = default_seed)
+	explicit basic_cmwc_engine(result_type s = default_seed)
 	{
 		seed(s);
 	}
 	void seed(result_type s = default_seed)
 	{
-		std::linear_congruential_engine<uint_fast32_t, 0x343FD, 0x269EC3, 0> lcg_rand(s);
-		for (size_t i = 0; i < Q.size(); ++i) {
-			Q[i] = lcg_rand();
+		// the low 32 bits of std::linear_congruential_engine<uint_fast32_t, 0x343FD, 0x269EC3, 0>,
+		// each value after the first SEED_LANES one jump of SEED_LANES steps from an earlier one,
+		// so that the loop has no short dependency chain and vectorizes
+		constexpr uint32_t a = cmwc_detail::lcg_a_lanes(), c = cmwc_detail::lcg_c_lanes();
+		uint32_t y = s;
+		for (size_t i = 0; i < std::min<size_t>(SEED_LANES, R); ++i) {
+			Q[i] = y = LCG_A * y + LCG_C;
+		}
+		for (size_t i = SEED_LANES; i < Q.size(); ++i) {
+			Q[i] = a * Q[i - SEED_LANES] + c;
 		}
+		y = Q.back();
 		do {
-			carry = lcg_rand();
-		} while (carry >= CMWC_C_MAX);
-		index = CMWC_CYCLE - 1;
+			carry = y = LCG_A * y + LCG_C;
+		} while (carry >= CMax);
+		index = R - 1;
 	}
 	result_type operator()()
 	{
-		index = (index + 1) & (CMWC_CYCLE - 1);
-		uint64_t t = 18782ull * Q[index] + carry;
-		carry = t >> 32;
-		uint32_t x = static_cast<uint32_t>(t + carry);
-		if (x < carry) {
-			++x;
-			++carry;
+		index = (index + 1) & (R - 1);
+		result_type x;
+		run(Q.data() + index, 1, &x);
+		return x;
+	}
+	// bulk output, same values as repeated operator()
+	void generate(result_type *first, result_type *last)
+	{
+		// runs of the table in index order, none of them past its end, so the
+		// index never wraps inside a run
+		size_t n = static_cast<size_t>(last - first);
+		while (n) {
+			const size_t pos = (index + 1) & (R - 1);
+			const size_t k = std::min<size_t>(n, R - pos);
+			run(Q.data() + pos, k, first);
+			index = static_cast<result_type>(pos + k - 1);
+			first += k;
+			n -= k;
 		}
-		return Q[index] = 0xfffffffe - x;
 	}
 	void discard(unsigned long long z)
 	{
-		while (z--) {
-			(*this)();
+		result_type buf[CHUNK];
+		while (z > CHUNK) {
+			generate(buf, buf + CHUNK);
+			z -= CHUNK;
 		}
+		generate(buf, buf + z);
 	}
 
-	friend bool operator==(const cmwc_engine &, const cmwc_engine &);
-	friend std::ostream& operator<<(std::ostream &, const cmwc_engine &);
-	friend std::istream& operator>>(std::istream &, cmwc_engine &);
+	template <uint32_t R2, uint32_t A2, uint32_t C2> friend bool operator==(const basic_cmwc_engine<R2, A2, C2> &, const basic_cmwc_engine<R2, A2, C2> &);
+	template <uint32_t R2, uint32_t A2, uint32_t C2> friend std::ostream& operator<<(std::ostream &, const basic_cmwc_engine<R2, A2, C2> &);
+	template <uint32_t R2, uint32_t A2, uint32_t C2> friend std::istream& operator>>(std::istream &, basic_cmwc_engine<R2, A2, C2> &);
 
 private:
-	enum : result_type { CMWC_CYCLE = 4096, CMWC_C_MAX = 809430660 };
+	enum : result_type { LCG_A = cmwc_detail::LCG_A, LCG_C = cmwc_detail::LCG_C };
+	enum : size_t { SEED_LANES = cmwc_detail::SEED_LANES, CHUNK = 256 };
+	enum : uint32_t { BRANCH_FREE_A = 1u << 28 }; // multipliers from which a step takes no branch
 
-	std::array<result_type, CMWC_CYCLE> Q;
+	std::array<result_type, R> Q;
 	result_type carry, index;
+
+	// k steps on the table entries q[0, k)
+	void run(uint32_t *q, size_t k, result_type *out)
+	{
+		uint32_t c = carry;
+		if constexpr (A < BRANCH_FREE_A) {
+			// the correction is taken about A / 2^32 of the time, and predicted
+			for (size_t i = 0; i < k; ++i) {
+				const uint64_t t = uint64_t(A) * q[i] + c;
+				c = t >> 32;
+				uint32_t x = static_cast<uint32_t>(t + c);
+				if (x < c) {
+					++x;
+					++c;
+				}
+				out[i] = q[i] = 0xfffffffe - x;
+			}
+		} else {
+			// the same step: A q + c is kept as c' b + x with x in [1, b], or 0
+			// for 0, so c' = (A q + c - 1) div b. With A q - 1 = hi b + lo, lo + 1 = w
+			// (both wrap to 0 for q = 0), a step is w + c with its carry out
+			// added to both halves: no branch, and off the products only an add
+			// and an add with carry stay in the dependency chain
+			for (size_t i = 0; i < k; ++i) {
+				const uint64_t v = uint64_t(A) * q[i] - 1;
+				const uint64_t s = (v >> 32) + static_cast<uint32_t>(v);
+				const uint32_t g = s >= 0xffffffff;
+				const uint32_t hi = static_cast<uint32_t>(v >> 32) + g, w = static_cast<uint32_t>(s) + g + 1;
+				const uint32_t sum = c + w;
+				const uint32_t f = sum < c;
+				c = hi + f;
+				out[i] = q[i] = 0xfffffffe - (sum + f);
+			}
+		}
+		carry = c;
+	}
 };
 
-bool operator==(const cmwc_engine &lhs, const cmwc_engine &rhs)
+template <uint32_t R, uint32_t A, uint32_t CMax>
+bool operator==(const basic_cmwc_engine<R, A, CMax> &lhs, const basic_cmwc_engine<R, A, CMax> &rhs)
 {
 	return (lhs.carry == rhs.carry)
 		&& (lhs.index == rhs.index)
 		&& (lhs.Q == rhs.Q);
 }
-bool operator!=(const cmwc_engine &lhs, const cmwc_engine &rhs)
+template <uint32_t R, uint32_t A, uint32_t CMax>
+bool operator!=(const basic_cmwc_engine<R, A, CMax> &lhs, const basic_cmwc_engine<R, A, CMax> &rhs)
 {
 	return !(lhs == rhs);
 }
-std::ostream& operator<<(std::ostream &os, const cmwc_engine &eng)
+template <uint32_t R, uint32_t A, uint32_t CMax>
+std::ostream& operator<<(std::ostream &os, const basic_cmwc_engine<R, A, CMax> &eng)
 {
 	for (size_t i = 0; i < eng.Q.size(); ++i) {
 		os << eng.Q[i] << ' ';
 	}
 	return os << eng.carry << ' ' << eng.index;
 }
-std::istream& operator>>(std::istream &is, cmwc_engine &eng)
+template <uint32_t R, uint32_t A, uint32_t CMax>
+std::istream& operator>>(std::istream &is, basic_cmwc_engine<R, A, CMax> &eng)
 {
 	for (size_t i = 0; i < eng.Q.size(); ++i) {
 		if (!(is >> eng.Q[i])) break;
@@ -85,4 +186,8 @@ std::istream& operator>>(std::istream &is, cmwc_engine &eng)
 	return is >> eng.carry >> eng.index;
 }
 
+using cmwc8_engine = basic_cmwc_engine<8, 4294967054u, 4294967054u>;
+using cmwc256_engine = basic_cmwc_engine<256, 987662290, 987662290>;
+using cmwc_engine = basic_cmwc_engine<4096, 18782, 809430660>;
+
 #endif // CMWC_RANDOM_H
@@ -0,0 +1,367 @@
+#ifndef ENGINE_ARRAY_H
+#define ENGINE_ARRAY_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "jsf32.hpp"
+#include "jsf64.hpp"
+#include "splitmix64_rand.hpp"
+#include "xoroshiro128_rand.hpp"
+#include "xoroshiro64_rand.hpp"
+#include "xoshiro128_rand.hpp"
+#include "xoshiro256_rand.hpp"
+
+// Structure-of-arrays storage for many independent small-state engines.
+// Word w of entity i lives at lane(w)[i], so stepping every entity is a
+// straight loop the compiler can vectorize. Entities step bit-exactly like
+// the engine objects they were loaded from.
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define ENGINE_ARRAY_IVDEP _Pragma("GCC ivdep")
+#elif defined(__clang__)
+#define ENGINE_ARRAY_IVDEP _Pragma("clang loop vectorize(enable)")
+#elif defined(_MSC_VER)
+#define ENGINE_ARRAY_IVDEP __pragma(loop(ivdep))
+#else
+#define ENGINE_ARRAY_IVDEP
+#endif
+
+namespace engine_array_detail
+{
+	template <typename T>
+	inline T rotl(const T x, int k)
+	{
+		return (x << k) | (x >> (sizeof(T) * 8 - k));
+	}
+}
+
+// state layout and transition of one engine, written against a local copy of its words
+template <typename Engine>
+struct engine_array_traits;
+
+template <>
+struct engine_array_traits<jsf32_engine>
+{
+	using word_type = uint32_t;
+	enum : size_t { words = 4 };
+
+	static uint32_t next(uint32_t (&x)[words])
+	{
+		using engine_array_detail::rotl;
+		const uint32_t e = x[0] - rotl(x[1], 27);
+		x[0] = x[1] ^ rotl(x[2], 17);
+		x[1] = x[2] + x[3];
+		x[2] = x[3] + e;
+		x[3] = e + x[0];
+		return x[3];
+	}
+};
+
+template <>
+struct engine_array_traits<jsf64_engine>
+{
+	using word_type = uint64_t;
+	enum : size_t { words = 4 };
+
+	static uint64_t next(uint64_t (&x)[words])
+	{
+		using engine_array_detail::rotl;
+		const uint64_t e = x[0] - rotl(x[1], 7);
+		x[0] = x[1] ^ rotl(x[2], 13);
+		x[1] = x[2] + rotl(x[3], 37);
+		x[2] = x[3] + e;
+		x[3] = e + x[0];
+		return x[3];
+	}
+};
+
+template <>
+struct engine_array_traits<splitmix64_engine>
+{
+	using word_type = uint64_t;
+	enum : size_t { words = 1 };
+
+	static uint64_t next(uint64_t (&x)[words])
+	{
+		uint64_t z = (x[0] += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+};
+
+template <>
+struct engine_array_traits<xoroshiro64_engine>
+{
+	using word_type = uint32_t;
+	enum : size_t { words = 2 };
+
+	static uint32_t next(uint32_t (&s)[words])
+	{
+		using engine_array_detail::rotl;
+		const uint32_t s0 = s[0];
+		uint32_t s1 = s[1];
+		const uint32_t result = rotl(s0 * 0x9E3779BB, 5) * 5;
+		s1 ^= s0;
+		s[0] = rotl(s0, 26) ^ s1 ^ (s1 << 9);
+		s[1] = rotl(s1, 13);
+		return result;
+	}
+};
+
+template <typename Scrambler>
+struct engine_array_traits<basic_xoroshiro128_engine<Scrambler>>
+{
+	using word_type = uint64_t;
+	enum : size_t { words = 2 };
+
+	static uint64_t next(uint64_t (&s)[words])
+	{
+		using engine_array_detail::rotl;
+		constexpr bool plusplus = std::is_same<Scrambler, xoshiro_scrambler::plusplus>::value;
+		const uint64_t s0 = s[0];
+		uint64_t s1 = s[1];
+		uint64_t result;
+		if constexpr (std::is_same<Scrambler, xoshiro_scrambler::plus>::value) {
+			result = s0 + s1;
+		} else if constexpr (plusplus) {
+			result = rotl(s0 + s1, 17) + s0;
+		} else {
+			result = rotl(s0 * 5, 7) * 9;
+		}
+		s1 ^= s0;
+		s[0] = rotl(s0, plusplus ? 49 : 24) ^ s1 ^ (s1 << (plusplus ? 21 : 16));
+		s[1] = rotl(s1, plusplus ? 28 : 37);
+		return result;
+	}
+};
+
+template <>
+struct engine_array_traits<xoshiro128_engine>
+{
+	using word_type = uint32_t;
+	enum : size_t { words = 4 };
+
+	static uint32_t next(uint32_t (&s)[words])
+	{
+		using engine_array_detail::rotl;
+		const uint32_t result = rotl(s[1] * 5, 7) * 9;
+		const uint32_t t = s[1] << 9;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 11);
+		return result;
+	}
+};
+
+template <typename Scrambler>
+struct engine_array_traits<basic_xoshiro256_engine<Scrambler>>
+{
+	using word_type = uint64_t;
+	enum : size_t { words = 4 };
+
+	static uint64_t next(uint64_t (&s)[words])
+	{
+		using engine_array_detail::rotl;
+		uint64_t result;
+		if constexpr (std::is_same<Scrambler, xoshiro_scrambler::plus>::value) {
+			result = s[0] + s[3];
+		} else if constexpr (std::is_same<Scrambler, xoshiro_scrambler::plusplus>::value) {
+			result = rotl(s[0] + s[3], 23) + s[0];
+		} else {
+			result = rotl(s[1] * 5, 7) * 9;
+		}
+		const uint64_t t = s[1] << 17;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 45);
+		return result;
+	}
+};
+
+template <typename Engine>
+class engine_array
+{
+	using traits = engine_array_traits<Engine>;
+	using word_type = typename traits::word_type;
+	enum : size_t { WORDS = traits::words, ALIGN = 64, LANE = ALIGN / sizeof(word_type) };
+
+	// entities are loaded from and stored to engine objects by their object representation
+	static_assert(std::is_trivially_copyable<Engine>::value, "engine must be trivially copyable");
+	static_assert(sizeof(Engine) == WORDS * sizeof(word_type), "engine object must hold exactly its state words");
+
+public:
+	using engine_type = Engine;
+	using result_type = typename Engine::result_type;
+
+	engine_array() = default;
+	// n copies of Engine()
+	explicit engine_array(size_t n) : engine_array(n, Engine()) {}
+	engine_array(size_t n, const Engine &eng)
+	{
+		allocate(n);
+		for (size_t i = 0; i < n; ++i) {
+			set(i, eng);
+		}
+	}
+	// one entity per seed
+	template <typename InputIt>
+	engine_array(InputIt first, InputIt last)
+	{
+		allocate(static_cast<size_t>(std::distance(first, last)));
+		for (size_t i = 0; first != last; ++first, ++i) {
+			set(i, Engine(*first));
+		}
+	}
+	engine_array(const engine_array &other)
+	{
+		allocate(other.count);
+		if (stride) {
+			std::memcpy(data.get(), other.data.get(), WORDS * stride * sizeof(word_type));
+		}
+	}
+	engine_array(engine_array &&other) noexcept
+		: data(std::move(other.data)), count(std::exchange(other.count, 0)), stride(std::exchange(other.stride, 0))
+	{
+	}
+	engine_array& operator=(engine_array other)
+	{
+		std::swap(data, other.data);
+		std::swap(count, other.count);
+		std::swap(stride, other.stride);
+		return *this;
+	}
+
+	size_t size() const { return count; }
+
+	Engine get(size_t i) const
+	{
+		word_type x[WORDS];
+		for (size_t w = 0; w < WORDS; ++w) {
+			x[w] = lane(w)[i];
+		}
+		Engine eng;
+		std::memcpy(&eng, x, sizeof x);
+		return eng;
+	}
+	void set(size_t i, const Engine &eng)
+	{
+		word_type x[WORDS];
+		std::memcpy(x, &eng, sizeof x);
+		for (size_t w = 0; w < WORDS; ++w) {
+			lane(w)[i] = x[w];
+		}
+	}
+	template <typename Seed>
+	void seed(size_t i, Seed s)
+	{
+		set(i, Engine(s));
+	}
+
+	// steps every entity once, out[i] receives the output of entity i
+	void advance(result_type *out)
+	{
+		step_all<true>(out, 1, std::make_index_sequence<WORDS>());
+	}
+	// steps every entity z times, dropping the output
+	void discard(unsigned long long z)
+	{
+		step_all<false>(nullptr, z, std::make_index_sequence<WORDS>());
+	}
+	// steps the entities listed in [first, last) in order, the k-th output goes to out[k]
+	// an index may repeat, each occurrence is one step
+	template <typename IndexIt>
+	void advance(IndexIt first, IndexIt last, result_type *out)
+	{
+		for (; first != last; ++first) {
+			const size_t i = static_cast<size_t>(*first);
+			word_type x[WORDS];
+			for (size_t w = 0; w < WORDS; ++w) {
+				x[w] = lane(w)[i];
+			}
+			*out++ = static_cast<result_type>(traits::next(x));
+			for (size_t w = 0; w < WORDS; ++w) {
+				lane(w)[i] = x[w];
+			}
+		}
+	}
+
+	friend bool operator==(const engine_array &lhs, const engine_array &rhs)
+	{
+		if (lhs.count != rhs.count) {
+			return false;
+		}
+		if (lhs.count == 0) {
+			return true;
+		}
+		for (size_t w = 0; w < WORDS; ++w) {
+			if (std::memcmp(lhs.lane(w), rhs.lane(w), lhs.count * sizeof(word_type))) {
+				return false;
+			}
+		}
+		return true;
+	}
+	friend bool operator!=(const engine_array &lhs, const engine_array &rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+private:
+	struct aligned_delete
+	{
+		void operator()(word_type *p) const
+		{
+			::operator delete(p, std::align_val_t(ALIGN));
+		}
+	};
+
+	std::unique_ptr<word_type[], aligned_delete> data;
+	size_t count = 0;
+	size_t stride = 0; // lane length, a multiple of the cache line
+
+	// the word loops are expanded from the index pack so the state of an entity
+	// stays in registers and the loop over entities can be vectorized
+	template <bool Output, size_t... W>
+	void step_all(result_type *out, unsigned long long z, std::index_sequence<W...>)
+	{
+		word_type *const s[WORDS] = { lane(W)... };
+		ENGINE_ARRAY_IVDEP
+		for (size_t i = 0; i < count; ++i) {
+			word_type x[WORDS] = { s[W][i]... };
+			if constexpr (Output) {
+				out[i] = static_cast<result_type>(traits::next(x));
+			} else {
+				for (unsigned long long k = 0; k < z; ++k) {
+					traits::next(x);
+				}
+			}
+			((s[W][i] = x[W]), ...);
+		}
+	}
+
+	void allocate(size_t n)
+	{
+		count = n;
+		stride = (n + LANE - 1) / LANE * LANE;
+		if (stride) {
+			data.reset(static_cast<word_type *>(::operator new(WORDS * stride * sizeof(word_type), std::align_val_t(ALIGN))));
+		}
+	}
+	word_type* lane(size_t w) { return data.get() + w * stride; }
+	const word_type* lane(size_t w) const { return data.get() + w * stride; }
+};
+
+#undef ENGINE_ARRAY_IVDEP
+
+#endif // ENGINE_ARRAY_H
@@ -0,0 +1,516 @@
+#ifndef FAST_DISTRIBUTIONS_H
+#define FAST_DISTRIBUTIONS_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include "rand_util.hpp"
+
+// Replacements for std::binomial_distribution, std::poisson_distribution and
+// std::geometric_distribution with the set-up terms cached in param_type.
+// Hormann, "The generation of binomial random variates", 1993 (BTRS)
+// Hormann, "The transformed rejection method for generating Poisson random variables", 1993 (PTRS)
+
+namespace fast_distributions_detail
+{
+	// log(k!) - ((k + 1/2) log(k + 1) - (k + 1) + log(2 pi) / 2)
+	inline double stirling_tail(double k)
+	{
+		static const double tail[] = {
+			0.0810614667953272, 0.0413406959554092, 0.0276779256849983, 0.02079067210376509,
+			0.0166446911898211, 0.0138761288230707, 0.0118967099458917, 0.0104112652619720,
+			0.00925546218271273, 0.00833056343336287
+		};
+		if (k <= 9) {
+			return tail[static_cast<int>(k)];
+		}
+		const double kp1sq = (k + 1) * (k + 1);
+		return (1.0 / 12 - (1.0 / 360 - 1.0 / 1260 / kp1sq) / kp1sq) / (k + 1);
+	}
+
+	inline double log_factorial(double k)
+	{
+		const double half_log_2pi = 0.91893853320467274178;
+		return (k + 0.5) * std::log(k + 1) - (k + 1) + half_log_2pi + stirling_tail(k);
+	}
+
+	template <typename IntType>
+	IntType clamp_cast(double x)
+	{
+		const double top = static_cast<double>(std::numeric_limits<IntType>::max());
+		return x >= top ? std::numeric_limits<IntType>::max() : static_cast<IntType>(x);
+	}
+}
+
+template <typename IntType = int>
+class fast_binomial_distribution
+{
+public:
+	using result_type = IntType;
+
+	class param_type
+	{
+	public:
+		using distribution_type = fast_binomial_distribution;
+
+		param_type() : param_type(1) {}
+		explicit param_type(IntType t, double p = 0.5) : t_(t), p_(p)
+		{
+			init();
+		}
+
+		IntType t() const { return t_; }
+		double p() const { return p_; }
+
+		friend bool operator==(const param_type &lhs, const param_type &rhs)
+		{
+			return lhs.t_ == rhs.t_ && lhs.p_ == rhs.p_;
+		}
+		friend bool operator!=(const param_type &lhs, const param_type &rhs)
+		{
+			return !(lhs == rhs);
+		}
+
+	private:
+		friend class fast_binomial_distribution;
+
+		IntType t_;
+		double p_;
+
+		// sampling is done for min(p, 1 - p) and mirrored
+		bool flip;
+		double q, n;
+		bool btrs;
+		// inversion
+		double qn, s, bound;
+		// BTRS
+		double a, b, c, vr, alpha, lpr, m, h;
+
+		void init()
+		{
+			using namespace fast_distributions_detail;
+			flip = p_ > 0.5;
+			const double pp = flip ? 1 - p_ : p_;
+			q = 1 - pp;
+			n = static_cast<double>(t_);
+			btrs = n * pp >= 10;
+			if (!btrs) {
+				qn = std::pow(q, n);
+				s = pp / q;
+				bound = std::min(n, n * pp + 10 * std::sqrt(n * pp * q + 1));
+			} else {
+				const double spq = std::sqrt(n * pp * q);
+				b = 1.15 + 2.53 * spq;
+				a = -0.0873 + 0.0248 * b + 0.01 * pp;
+				c = n * pp + 0.5;
+				vr = 0.92 - 4.2 / b;
+				alpha = (2.83 + 5.1 / b) * spq;
+				lpr = std::log(pp / q);
+				m = std::floor((n + 1) * pp);
+				h = (m + 0.5) * std::log((m + 1) / ((pp / q) * (n - m + 1)))
+					+ stirling_tail(m) + stirling_tail(n - m);
+			}
+		}
+	};
+
+	fast_binomial_distribution() = default;
+	explicit fast_binomial_distribution(IntType t, double p = 0.5) : par(t, p) {}
+	explicit fast_binomial_distribution(const param_type &p) : par(p) {}
+
+	void reset() {}
+
+	IntType t() const { return par.t(); }
+	double p() const { return par.p(); }
+	param_type param() const { return par; }
+	void param(const param_type &p) { par = p; }
+	result_type min() const { return 0; }
+	result_type max() const { return par.t(); }
+
+	template <typename URBG>
+	result_type operator()(URBG &g)
+	{
+		return (*this)(g, par);
+	}
+	template <typename URBG>
+	result_type operator()(URBG &g, const param_type &p)
+	{
+		if (p.t_ == 0 || p.p_ == 0) {
+			return 0;
+		}
+		if (p.p_ == 1) {
+			return p.t_;
+		}
+		const double k = p.btrs ? btrs(g, p) : inversion(g, p);
+		return static_cast<result_type>(p.flip ? p.n - k : k);
+	}
+
+	// bulk sampling
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g)
+	{
+		generate(first, last, g, par);
+	}
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g, const param_type &p)
+	{
+		for (; first != last; ++first) {
+			*first = (*this)(g, p);
+		}
+	}
+
+	friend bool operator==(const fast_binomial_distribution &lhs, const fast_binomial_distribution &rhs)
+	{
+		return lhs.par == rhs.par;
+	}
+	friend bool operator!=(const fast_binomial_distribution &lhs, const fast_binomial_distribution &rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <typename CharT, typename Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits> &os, const fast_binomial_distribution &d)
+	{
+		const auto precision = os.precision(std::numeric_limits<double>::max_digits10);
+		os << d.t() << ' ' << d.p();
+		os.precision(precision);
+		return os;
+	}
+	template <typename CharT, typename Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits> &is, fast_binomial_distribution &d)
+	{
+		IntType t;
+		double p;
+		if (is >> t >> p) {
+			d.par = param_type(t, p);
+		}
+		return is;
+	}
+
+private:
+	param_type par;
+
+	template <typename URBG>
+	static double inversion(URBG &g, const param_type &p)
+	{
+		double x = 0, px = p.qn, u = rand_util::canonical(g);
+		while (u > px) {
+			if (++x > p.bound) {
+				x = 0;
+				px = p.qn;
+				u = rand_util::canonical(g);
+			} else {
+				u -= px;
+				px *= ((p.n - x + 1) * p.s) / x;
+			}
+		}
+		return x;
+	}
+
+	template <typename URBG>
+	static double btrs(URBG &g, const param_type &p)
+	{
+		using namespace fast_distributions_detail;
+		for (;;) {
+			const double u = rand_util::canonical(g) - 0.5;
+			double v = rand_util::canonical(g);
+			const double us = 0.5 - std::fabs(u);
+			const double k = std::floor((2 * p.a / us + p.b) * u + p.c);
+			if (k < 0 || k > p.n) {
+				continue;
+			}
+			if (us >= 0.07 && v <= p.vr) {
+				return k;
+			}
+			v = std::log(v * p.alpha / (p.a / (us * us) + p.b));
+			const double upper = p.h
+				+ (p.n + 1) * std::log((p.n - p.m + 1) / (p.n - k + 1))
+				+ (k + 0.5) * (p.lpr + std::log((p.n - k + 1) / (k + 1)))
+				- stirling_tail(k) - stirling_tail(p.n - k);
+			if (v <= upper) {
+				return k;
+			}
+		}
+	}
+};
+
+template <typename IntType = int>
+class fast_poisson_distribution
+{
+public:
+	using result_type = IntType;
+
+	class param_type
+	{
+	public:
+		using distribution_type = fast_poisson_distribution;
+
+		param_type() : param_type(1.0) {}
+		explicit param_type(double mean) : mean_(mean)
+		{
+			init();
+		}
+
+		double mean() const { return mean_; }
+
+		friend bool operator==(const param_type &lhs, const param_type &rhs)
+		{
+			return lhs.mean_ == rhs.mean_;
+		}
+		friend bool operator!=(const param_type &lhs, const param_type &rhs)
+		{
+			return !(lhs == rhs);
+		}
+
+	private:
+		friend class fast_poisson_distribution;
+
+		double mean_;
+
+		bool ptrs;
+		// inversion
+		double emu, bound;
+		// PTRS
+		double loglam, a, b, vr, log_invalpha;
+
+		void init()
+		{
+			ptrs = mean_ >= 10;
+			if (!ptrs) {
+				emu = std::exp(-mean_);
+				bound = mean_ + 10 * std::sqrt(mean_ + 1);
+			} else {
+				const double slam = std::sqrt(mean_);
+				loglam = std::log(mean_);
+				b = 0.931 + 2.53 * slam;
+				a = -0.059 + 0.02483 * b;
+				vr = 0.9277 - 3.6224 / (b - 2);
+				log_invalpha = std::log(1.1239 + 1.1328 / (b - 3.4));
+			}
+		}
+	};
+
+	fast_poisson_distribution() = default;
+	explicit fast_poisson_distribution(double mean) : par(mean) {}
+	explicit fast_poisson_distribution(const param_type &p) : par(p) {}
+
+	void reset() {}
+
+	double mean() const { return par.mean(); }
+	param_type param() const { return par; }
+	void param(const param_type &p) { par = p; }
+	result_type min() const { return 0; }
+	result_type max() const { return std::numeric_limits<result_type>::max(); }
+
+	template <typename URBG>
+	result_type operator()(URBG &g)
+	{
+		return (*this)(g, par);
+	}
+	template <typename URBG>
+	result_type operator()(URBG &g, const param_type &p)
+	{
+		if (p.mean_ <= 0) {
+			return 0;
+		}
+		return fast_distributions_detail::clamp_cast<result_type>(p.ptrs ? ptrs(g, p) : inversion(g, p));
+	}
+
+	// bulk sampling
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g)
+	{
+		generate(first, last, g, par);
+	}
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g, const param_type &p)
+	{
+		for (; first != last; ++first) {
+			*first = (*this)(g, p);
+		}
+	}
+
+	friend bool operator==(const fast_poisson_distribution &lhs, const fast_poisson_distribution &rhs)
+	{
+		return lhs.par == rhs.par;
+	}
+	friend bool operator!=(const fast_poisson_distribution &lhs, const fast_poisson_distribution &rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <typename CharT, typename Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits> &os, const fast_poisson_distribution &d)
+	{
+		const auto precision = os.precision(std::numeric_limits<double>::max_digits10);
+		os << d.mean();
+		os.precision(precision);
+		return os;
+	}
+	template <typename CharT, typename Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits> &is, fast_poisson_distribution &d)
+	{
+		double mean;
+		if (is >> mean) {
+			d.par = param_type(mean);
+		}
+		return is;
+	}
+
+private:
+	param_type par;
+
+	template <typename URBG>
+	static double inversion(URBG &g, const param_type &p)
+	{
+		double x = 0, px = p.emu, u = rand_util::canonical(g);
+		while (u > px) {
+			if (++x > p.bound) {
+				x = 0;
+				px = p.emu;
+				u = rand_util::canonical(g);
+			} else {
+				u -= px;
+				px *= p.mean_ / x;
+			}
+		}
+		return x;
+	}
+
+	template <typename URBG>
+	static double ptrs(URBG &g, const param_type &p)
+	{
+		using namespace fast_distributions_detail;
+		for (;;) {
+			const double u = rand_util::canonical(g) - 0.5;
+			const double v = rand_util::canonical(g);
+			const double us = 0.5 - std::fabs(u);
+			const double k = std::floor((2 * p.a / us + p.b) * u + p.mean_ + 0.43);
+			if (us >= 0.07 && v <= p.vr) {
+				return k;
+			}
+			if (k < 0 || (us < 0.013 && v > us)) {
+				continue;
+			}
+			if (std::log(v) + p.log_invalpha - std::log(p.a / (us * us) + p.b)
+				<= -p.mean_ + k * p.loglam - log_factorial(k)) {
+				return k;
+			}
+		}
+	}
+};
+
+template <typename IntType = int>
+class fast_geometric_distribution
+{
+public:
+	using result_type = IntType;
+
+	class param_type
+	{
+	public:
+		using distribution_type = fast_geometric_distribution;
+
+		param_type() : param_type(0.5) {}
+		explicit param_type(double p) : p_(p)
+		{
+			init();
+		}
+
+		double p() const { return p_; }
+
+		friend bool operator==(const param_type &lhs, const param_type &rhs)
+		{
+			return lhs.p_ == rhs.p_;
+		}
+		friend bool operator!=(const param_type &lhs, const param_type &rhs)
+		{
+			return !(lhs == rhs);
+		}
+
+	private:
+		friend class fast_geometric_distribution;
+
+		double p_;
+		double inv_log_q; // 1 / log(1 - p)
+
+		void init()
+		{
+			inv_log_q = 1 / std::log1p(-p_);
+		}
+	};
+
+	fast_geometric_distribution() = default;
+	explicit fast_geometric_distribution(double p) : par(p) {}
+	explicit fast_geometric_distribution(const param_type &p) : par(p) {}
+
+	void reset() {}
+
+	double p() const { return par.p(); }
+	param_type param() const { return par; }
+	void param(const param_type &p) { par = p; }
+	result_type min() const { return 0; }
+	result_type max() const { return std::numeric_limits<result_type>::max(); }
+
+	template <typename URBG>
+	result_type operator()(URBG &g)
+	{
+		return (*this)(g, par);
+	}
+	template <typename URBG>
+	result_type operator()(URBG &g, const param_type &p)
+	{
+		if (p.p_ >= 1) {
+			return 0;
+		}
+		// u in (0, 1]
+		const double u = 1 - rand_util::canonical(g);
+		return fast_distributions_detail::clamp_cast<result_type>(std::floor(std::log(u) * p.inv_log_q));
+	}
+
+	// bulk sampling
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g)
+	{
+		generate(first, last, g, par);
+	}
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g, const param_type &p)
+	{
+		for (; first != last; ++first) {
+			*first = (*this)(g, p);
+		}
+	}
+
+	friend bool operator==(const fast_geometric_distribution &lhs, const fast_geometric_distribution &rhs)
+	{
+		return lhs.par == rhs.par;
+	}
+	friend bool operator!=(const fast_geometric_distribution &lhs, const fast_geometric_distribution &rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <typename CharT, typename Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits> &os, const fast_geometric_distribution &d)
+	{
+		const auto precision = os.precision(std::numeric_limits<double>::max_digits10);
+		os << d.p();
+		os.precision(precision);
+		return os;
+	}
+	template <typename CharT, typename Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits> &is, fast_geometric_distribution &d)
+	{
+		double p;
+		if (is >> p) {
+			d.par = param_type(p);
+		}
+		return is;
+	}
+
+private:
+	param_type par;
+};
+
+#endif // FAST_DISTRIBUTIONS_H
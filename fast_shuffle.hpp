@@ -0,0 +1,128 @@
+#ifndef FAST_SHUFFLE_H
+#define FAST_SHUFFLE_H
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <xmmintrin.h> // _mm_prefetch
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include "rand_util.hpp"
+
+// Fisher-Yates shuffle and k-subset sampling on top of batched bounded draws.
+// Brackett-Incorvaia, Lemire, "Batched Ranged Random Integer Generation", 2024
+
+namespace fast_shuffle_detail
+{
+	inline void prefetch(const void *p)
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		_mm_prefetch(static_cast<const char *>(p), _MM_HINT_T0);
+#else
+		__builtin_prefetch(p, 1);
+#endif
+	}
+
+	// indices drawn from one 64-bit word for a range of size n,
+	// chosen so the product of the consecutive ranges stays below 2^64
+	inline size_t batch_size(uint64_t n)
+	{
+		if (n > (1ull << 30)) return 1;
+		if (n > (1ull << 19)) return 2;
+		if (n > (1ull << 14)) return 3;
+		if (n > (1ull << 11)) return 4;
+		if (n > (1ull << 9))  return 5;
+		return 6;
+	}
+
+	enum : size_t { BLOCK = 64, PREFETCH_MIN = 1 << 16 };
+
+	// the swap targets of up to BLOCK positions from i down, they do not depend on the data
+	template <typename URBG>
+	size_t draw_block(uint64_t i, uint64_t *idx, URBG &g)
+	{
+		uint64_t ranges[6];
+		size_t n = 0;
+		while (n + 6 <= BLOCK && i - n > 1) {
+			const uint64_t r = i - n;
+			const size_t k = static_cast<size_t>(std::min<uint64_t>(batch_size(r), r - 1));
+			for (size_t j = 0; j < k; ++j) {
+				ranges[j] = r - j;
+			}
+			rand_util::random_bounded_batch(ranges, k, idx + n, g);
+			n += k;
+		}
+		return n;
+	}
+}
+
+template <typename RandomIt, typename URBG>
+void fast_shuffle(RandomIt first, RandomIt last, URBG &&g)
+{
+	using namespace fast_shuffle_detail;
+	using std::swap;
+
+	const uint64_t size = static_cast<uint64_t>(last - first);
+	const bool prefetching = size >= PREFETCH_MIN;
+
+	// the targets of the next block are drawn and prefetched before the current
+	// block is swapped, so their loads overlap its swaps
+	uint64_t idx[2][BLOCK];
+	uint64_t i = size;
+	size_t n = draw_block(i, idx[0], g);
+	if (prefetching) {
+		for (size_t j = 0; j < n; ++j) {
+			prefetch(std::addressof(first[idx[0][j]]));
+		}
+	}
+	for (size_t cur = 0; n; cur ^= 1) {
+		const size_t next = draw_block(i - n, idx[cur ^ 1], g);
+		if (prefetching) {
+			for (size_t j = 0; j < next; ++j) {
+				prefetch(std::addressof(first[idx[cur ^ 1][j]]));
+			}
+		}
+		for (size_t j = 0; j < n; ++j, --i) {
+			swap(first[i - 1], first[idx[cur][j]]);
+		}
+		n = next;
+	}
+}
+
+// k distinct values from [0, n) in no particular order, O(k) draws and memory
+// Floyd's algorithm, Bentley, "Programming Pearls: A sample of brilliance", 1987
+template <typename OutputIt, typename URBG>
+OutputIt sample_k(uint64_t n, uint64_t k, OutputIt out, URBG &&g)
+{
+	k = std::min(k, n);
+	std::unordered_set<uint64_t> chosen;
+	chosen.reserve(static_cast<size_t>(k));
+	for (uint64_t j = n - k; j < n; ++j) {
+		uint64_t t = rand_util::random_bounded(j + 1, g);
+		if (!chosen.insert(t).second) {
+			chosen.insert(t = j);
+		}
+		*out++ = t;
+	}
+	return out;
+}
+
+// k distinct values from [0, n) in increasing order, O(n) draws and O(1) memory
+// selection sampling, Knuth TAOCP Vol. 2, 3.4.2 Algorithm S
+template <typename OutputIt, typename URBG>
+OutputIt sample_k_sequential(uint64_t n, uint64_t k, OutputIt out, URBG &&g)
+{
+	k = std::min(k, n);
+	for (uint64_t t = 0; k; ++t) {
+		if (rand_util::random_bounded(n - t, g) < k) {
+			*out++ = t;
+			--k;
+		}
+	}
+	return out;
+}
+
+#endif // FAST_SHUFFLE_H
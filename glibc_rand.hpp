@@ -1,9 +1,12 @@
 #ifndef GLIBC_RANDOM_H
 #define GLIBC_RANDOM_H
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <iosfwd>
 #include <limits>
 #include <random>
+#include "lcg_rand.hpp"
 
 class glibc_engine // glibc (TYPE_0)
 {
@@ -25,7 +28,7 @@ public:
 	}
 	void discard(unsigned long long z)
 	{
-		engine.discard(z);
+		lcg_discard(engine, z);
 	}
 
 	friend bool operator==(const glibc_engine &, const glibc_engine &);
@@ -56,4 +59,150 @@ std::istream& operator>>(std::istream &is, glibc_engine &eng)
 	return is >> eng.engine;
 }
 
+class glibc_random_engine // glibc random() (TYPE_3)
+{
+public:
+	using result_type = uint32_t;
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return M31; }
+	static constexpr result_type default_seed = 1;
+
+	explicit glibc_random_engine(result_type s = default_seed)
+	{
+		seed(s);
+	}
+	// srandom(s): the Park-Miller sequence, then 310 values discarded
+	void seed(result_type s = default_seed)
+	{
+		if (s == 0) {
+			s = 1;
+		}
+		int32_t word = static_cast<int32_t>(s);
+		r[0] = s;
+		for (size_t i = 1; i < DEG; ++i) {
+			// r[i] = 16807 * r[i - 1] % 2147483647 without overflow, with glibc's arithmetic
+			const int64_t hi = word / 127773, lo = word % 127773;
+			word = static_cast<int32_t>(16807 * lo - 2836 * hi);
+			if (word < 0) {
+				word += 2147483647;
+			}
+			r[i] = static_cast<uint32_t>(word);
+		}
+		front = SEP;
+		for (size_t i = 0; i < 10 * DEG; ++i) {
+			(*this)();
+		}
+	}
+	result_type operator()()
+	{
+		// r[front] holds x[n - 31], the slot SEP behind it x[n - 3]
+		const size_t rear = front >= SEP ? front - SEP : front + DEG - SEP;
+		const uint32_t x = r[front] += r[rear];
+		if (++front == DEG) {
+			front = 0;
+		}
+		return x >> 1;
+	}
+	// bulk output, same values as repeated operator()
+	void generate(result_type *first, result_type *last)
+	{
+		// x[n] = x[n - 31] + x[n - 3], with x[n - 3] substituted five times:
+		// x[n] = x[n - 31] + x[n - 34] + ... + x[n - 46] + x[n - 18]. Nothing
+		// closer than 18 values back is read, so a step makes a whole vector
+		// of outputs, and its loads miss the stores still in flight
+		uint32_t x[HIST + CHUNK];
+		size_t n = static_cast<size_t>(last - first);
+		if (n < HIST) {
+			while (first != last) {
+				*first++ = (*this)();
+			}
+			return;
+		}
+		for (size_t i = 0; i < DEG; ++i) {
+			x[i] = r[front + i < DEG ? front + i : front + i - DEG];
+		}
+		for (size_t i = DEG; i < HIST; ++i) {
+			x[i] = x[i - DEG] + x[i - SEP];
+			*first++ = x[i] >> 1;
+		}
+		n -= HIST - DEG;
+		while (n) {
+			// whole chunks, a fixed trip count vectorizes at -O2
+			for (size_t i = HIST; i < HIST + CHUNK; ++i) {
+				x[i] = x[i - 31] + x[i - 34] + x[i - 37] + x[i - 40] + x[i - 43] + x[i - 46] + x[i - 18];
+			}
+			const size_t k = std::min<size_t>(CHUNK, n);
+			if (k == CHUNK) {
+				for (size_t i = 0; i < CHUNK; ++i) {
+					first[i] = x[HIST + i] >> 1;
+				}
+			} else {
+				for (size_t i = 0; i < k; ++i) {
+					first[i] = x[HIST + i] >> 1;
+				}
+			}
+			std::copy(x + k, x + k + HIST, x);
+			first += k;
+			n -= k;
+		}
+		std::copy(x + HIST - DEG, x + HIST, r);
+		front = 0;
+	}
+	void discard(unsigned long long z)
+	{
+		result_type buf[HIST + CHUNK];
+		while (z > HIST + CHUNK) {
+			generate(buf, buf + HIST + CHUNK);
+			z -= HIST + CHUNK;
+		}
+		generate(buf, buf + z);
+	}
+
+	friend bool operator==(const glibc_random_engine &, const glibc_random_engine &);
+	friend std::ostream& operator<<(std::ostream &, const glibc_random_engine &);
+	friend std::istream& operator>>(std::istream &, glibc_random_engine &);
+
+private:
+	enum : size_t { DEG = 31, SEP = 3, HIST = 48, CHUNK = 256 };
+	enum : result_type { M31 = (1u << 31) - 1 }; // bits 30..0
+
+	uint32_t r[DEG]; // circular, oldest value at front
+	size_t front;
+
+	uint32_t at(size_t i) const // i-th oldest
+	{
+		return r[front + i < DEG ? front + i : front + i - DEG];
+	}
+};
+
+bool operator==(const glibc_random_engine &lhs, const glibc_random_engine &rhs)
+{
+	for (size_t i = 0; i < lhs.DEG; ++i) {
+		if (lhs.at(i) != rhs.at(i)) {
+			return false;
+		}
+	}
+	return true;
+}
+bool operator!=(const glibc_random_engine &lhs, const glibc_random_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const glibc_random_engine &eng)
+{
+	for (size_t i = 0; i < eng.DEG; ++i) {
+		os << eng.at(i) << ' ';
+	}
+	return os;
+}
+std::istream& operator>>(std::istream &is, glibc_random_engine &eng)
+{
+	for (auto &value : eng.r) {
+		is >> value;
+	}
+	eng.front = 0;
+	return is;
+}
+
 #endif // GLIBC_RANDOM_H
@@ -0,0 +1,443 @@
+#ifndef INSTRUMENTED_ENGINE_H
+#define INSTRUMENTED_ENGINE_H
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "cmwc_rand.hpp"
+#include "isaac64_rand.hpp"
+#include "isaac_rand.hpp"
+#include "mt19937_rand.hpp"
+#include "sfmt_rand.hpp"
+
+// instrumented_engine<Engine> behaves like Engine and counts, per channel,
+// the single draws, the bytes of bulk fills, the seeds, the discarded values
+// and the refills of block engines (isaac, isaac64, cmwc index wraps,
+// mt19937, SFMT). Channels are named, so components can be told apart:
+//
+//   instrumented_engine<isaac64_engine> eng(instrument_channel::get("shuffle"), seed);
+//   for (auto &s : instrument_channel::snapshot_all()) ...
+//
+// Each thread counts into its own cache line of the channel, without atomic
+// read-modify-writes; snapshots add the lines up and may be taken at any time.
+// A line goes to the next new thread when its thread exits, counts and all;
+// past 127 threads alive at once, the others share one line with atomic adds.
+// Refills are counted from the position since the last seed, so an adapter
+// wrapping an engine that is in the middle of a block is off by at most one.
+//
+// INSTRUMENTED_ENGINE=0 compiles the counting out: instrumented_engine<Engine>
+// then has the size of Engine and its members are plain forwarders.
+// INSTRUMENTED_ENGINE_LATENCY=1 also times one in INSTRUMENTED_ENGINE_SAMPLE
+// draws and bulk fills per thread with rdtsc (steady_clock ticks elsewhere),
+// into log2 histograms.
+
+#ifndef INSTRUMENTED_ENGINE
+#define INSTRUMENTED_ENGINE 1
+#endif
+#ifndef INSTRUMENTED_ENGINE_LATENCY
+#define INSTRUMENTED_ENGINE_LATENCY 0
+#endif
+#ifndef INSTRUMENTED_ENGINE_SAMPLE
+#define INSTRUMENTED_ENGINE_SAMPLE 1024
+#endif
+
+// block of results produced at once, and the draw after seed() that first produces one
+template <typename Engine>
+struct instrument_block
+{
+	static constexpr uint64_t size = 0;
+	static constexpr uint64_t first = 0;
+};
+
+template <> struct instrument_block<isaac_engine> { static constexpr uint64_t size = 256, first = 257; };
+template <> struct instrument_block<isaac64_engine> { static constexpr uint64_t size = 256, first = 257; };
+template <> struct instrument_block<mt19937_engine> { static constexpr uint64_t size = 624, first = 1; };
+template <> struct instrument_block<sfmt19937_engine> { static constexpr uint64_t size = 624, first = 1; };
+template <> struct instrument_block<dsfmt19937_engine> { static constexpr uint64_t size = 382, first = 1; };
+template <uint32_t R, uint32_t A, uint32_t CMax>
+struct instrument_block<basic_cmwc_engine<R, A, CMax>> { static constexpr uint64_t size = R, first = 1; };
+
+struct instrument_snapshot
+{
+	enum : size_t { BUCKETS = 32 };
+
+	std::string name;
+	uint64_t draws = 0;
+	uint64_t bulk_bytes = 0;
+	uint64_t seeds = 0;
+	uint64_t discards = 0;
+	uint64_t refills = 0;
+	// sampled latencies, bucket b counts [2^b, 2^(b+1)) ticks
+	std::array<uint64_t, BUCKETS> draw_ticks{};
+	std::array<uint64_t, BUCKETS> bulk_ticks{};
+};
+
+namespace instrument_detail
+{
+	enum : unsigned { SLOTS = 128 };
+	enum : uint64_t { SAMPLE = INSTRUMENTED_ENGINE_SAMPLE };
+	enum : size_t { BUCKETS = instrument_snapshot::BUCKETS };
+
+	struct alignas(64) slot
+	{
+		std::atomic<uint64_t> draws{ 0 }, bulk_bytes{ 0 }, seeds{ 0 }, discards{ 0 }, refills{ 0 };
+		std::atomic<uint64_t> sample{ 0 };
+#if INSTRUMENTED_ENGINE_LATENCY
+		std::atomic<uint64_t> draw_ticks[BUCKETS] = {}, bulk_ticks[BUCKETS] = {};
+#endif
+	};
+
+	// slot numbers of the live threads, the last one shared by those past SLOTS - 1
+	class slot_pool
+	{
+	public:
+		unsigned acquire()
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if (!free.empty()) {
+				const unsigned s = free.back();
+				free.pop_back();
+				return s;
+			}
+			return next < SLOTS - 1 ? next++ : SLOTS - 1;
+		}
+		void release(unsigned s)
+		{
+			if (s != SLOTS - 1) {
+				std::lock_guard<std::mutex> guard(lock);
+				free.push_back(s);
+			}
+		}
+
+	private:
+		std::mutex lock;
+		std::vector<unsigned> free;
+		unsigned next = 0;
+	};
+
+	// never destroyed, threads may exit after static destruction
+	inline slot_pool& slot_numbers()
+	{
+		static slot_pool *pool = new slot_pool;
+		return *pool;
+	}
+
+	// the calling thread's slot, given back when it exits
+	struct held_slot
+	{
+		held_slot() : s(slot_numbers().acquire()) {}
+		~held_slot() { slot_numbers().release(s); }
+
+		const unsigned s;
+	};
+
+	inline unsigned thread_slot()
+	{
+		thread_local const held_slot held;
+		return held.s;
+	}
+
+	inline void add(std::atomic<uint64_t> &counter, uint64_t n, bool shared)
+	{
+		if (shared) {
+			counter.fetch_add(n, std::memory_order_relaxed);
+		} else {
+			counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+		}
+	}
+
+	inline uint64_t ticks()
+	{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+
+	inline size_t bucket(uint64_t t)
+	{
+		size_t b = 0;
+		while (t >>= 1) {
+			++b;
+		}
+		return std::min<size_t>(b, BUCKETS - 1);
+	}
+}
+
+class instrument_channel
+{
+public:
+	explicit instrument_channel(std::string name) : label(std::move(name)) {}
+	instrument_channel(const instrument_channel &) = delete;
+	instrument_channel& operator=(const instrument_channel &) = delete;
+
+	// the channel of that name, created on first use and never destroyed
+	static instrument_channel& get(const std::string &name)
+	{
+		std::lock_guard<std::mutex> lock(registry_mutex());
+		auto &entry = registry()[name];
+		if (!entry) {
+			entry.reset(new instrument_channel(name));
+		}
+		return *entry;
+	}
+	static std::vector<instrument_snapshot> snapshot_all()
+	{
+		std::lock_guard<std::mutex> lock(registry_mutex());
+		std::vector<instrument_snapshot> result;
+		for (auto &entry : registry()) {
+			result.push_back(entry.second->snapshot());
+		}
+		return result;
+	}
+
+	const std::string& name() const { return label; }
+
+	instrument_snapshot snapshot() const
+	{
+		instrument_snapshot s;
+		s.name = label;
+		for (auto &sl : slots) {
+			s.draws += sl.draws.load(std::memory_order_relaxed);
+			s.bulk_bytes += sl.bulk_bytes.load(std::memory_order_relaxed);
+			s.seeds += sl.seeds.load(std::memory_order_relaxed);
+			s.discards += sl.discards.load(std::memory_order_relaxed);
+			s.refills += sl.refills.load(std::memory_order_relaxed);
+#if INSTRUMENTED_ENGINE_LATENCY
+			for (size_t b = 0; b < instrument_snapshot::BUCKETS; ++b) {
+				s.draw_ticks[b] += sl.draw_ticks[b].load(std::memory_order_relaxed);
+				s.bulk_ticks[b] += sl.bulk_ticks[b].load(std::memory_order_relaxed);
+			}
+#endif
+		}
+		return s;
+	}
+
+	// the calling thread's slot, and whether other threads write to it too
+	instrument_detail::slot& local(bool &shared)
+	{
+		const unsigned s = instrument_detail::thread_slot();
+		shared = s == instrument_detail::SLOTS - 1;
+		return slots[s];
+	}
+
+private:
+	std::string label;
+	instrument_detail::slot slots[instrument_detail::SLOTS];
+
+	static std::map<std::string, std::unique_ptr<instrument_channel>>& registry()
+	{
+		static std::map<std::string, std::unique_ptr<instrument_channel>> channels;
+		return channels;
+	}
+	static std::mutex& registry_mutex()
+	{
+		static std::mutex m;
+		return m;
+	}
+};
+
+namespace instrument_detail
+{
+	template <typename Engine, typename = void>
+	struct has_generate : std::false_type {};
+	template <typename Engine>
+	struct has_generate<Engine, decltype(std::declval<Engine &>().generate(
+		std::declval<typename Engine::result_type *>(), std::declval<typename Engine::result_type *>()))> : std::true_type {};
+
+	template <typename Engine>
+	void fill(Engine &eng, typename Engine::result_type *first, typename Engine::result_type *last)
+	{
+		if constexpr (has_generate<Engine>::value) {
+			eng.generate(first, last);
+		} else {
+			while (first != last) {
+				*first++ = eng();
+			}
+		}
+	}
+
+	// compiled out: nothing but forwarding
+	template <typename Engine, bool Enabled>
+	class hook
+	{
+	protected:
+		hook() = default;
+		explicit hook(instrument_channel *) {}
+
+		instrument_channel* channel() const { return nullptr; }
+
+		void seed(Engine &eng, typename Engine::result_type value) { eng.seed(value); }
+		typename Engine::result_type draw(Engine &eng) { return eng(); }
+		void bulk(Engine &eng, typename Engine::result_type *first, typename Engine::result_type *last) { fill(eng, first, last); }
+		void skip(Engine &eng, unsigned long long z) { eng.discard(z); }
+	};
+
+	template <typename Engine>
+	class hook<Engine, true>
+	{
+	protected:
+		hook() : hook(&instrument_channel::get("default")) {}
+		explicit hook(instrument_channel *c) : chan(c) {}
+
+		instrument_channel* channel() const { return chan; }
+
+		void seed(Engine &eng, typename Engine::result_type value)
+		{
+			bool shared;
+			slot &sl = chan->local(shared);
+			add(sl.seeds, 1, shared);
+			eng.seed(value);
+			until_refill = block::first;
+		}
+		typename Engine::result_type draw(Engine &eng)
+		{
+			bool shared;
+			slot &sl = chan->local(shared);
+			add(sl.draws, 1, shared);
+			advance(sl, 1, shared);
+#if INSTRUMENTED_ENGINE_LATENCY
+			if (due(sl)) {
+				const uint64_t t0 = ticks();
+				const auto result = eng();
+				add(sl.draw_ticks[bucket(ticks() - t0)], 1, shared);
+				return result;
+			}
+#endif
+			return eng();
+		}
+		void bulk(Engine &eng, typename Engine::result_type *first, typename Engine::result_type *last)
+		{
+			const uint64_t n = static_cast<uint64_t>(last - first);
+			bool shared;
+			slot &sl = chan->local(shared);
+			add(sl.bulk_bytes, n * sizeof(typename Engine::result_type), shared);
+			advance(sl, n, shared);
+#if INSTRUMENTED_ENGINE_LATENCY
+			if (due(sl)) {
+				const uint64_t t0 = ticks();
+				fill(eng, first, last);
+				add(sl.bulk_ticks[bucket(ticks() - t0)], 1, shared);
+				return;
+			}
+#endif
+			fill(eng, first, last);
+		}
+		void skip(Engine &eng, unsigned long long z)
+		{
+			bool shared;
+			slot &sl = chan->local(shared);
+			add(sl.discards, z, shared);
+			advance(sl, z, shared);
+			eng.discard(z);
+		}
+
+	private:
+		using block = instrument_block<Engine>;
+
+		instrument_channel *chan;
+		uint64_t until_refill = block::first; // draws up to and including the next refill
+
+		void advance(slot &sl, uint64_t n, bool shared)
+		{
+			if constexpr (block::size != 0) {
+				if (n >= until_refill) {
+					n -= until_refill;
+					add(sl.refills, 1 + n / block::size, shared);
+					until_refill = block::size - n % block::size;
+				} else {
+					until_refill -= n;
+				}
+			}
+		}
+#if INSTRUMENTED_ENGINE_LATENCY
+		static bool due(slot &sl)
+		{
+			// a thread's own counter, a lost update on the shared slot only shifts the sampling
+			const uint64_t k = sl.sample.load(std::memory_order_relaxed) + 1;
+			sl.sample.store(k, std::memory_order_relaxed);
+			return k % SAMPLE == 0;
+		}
+#endif
+	};
+}
+
+template <typename Engine>
+class instrumented_engine : private instrument_detail::hook<Engine, INSTRUMENTED_ENGINE != 0>
+{
+	using hook = instrument_detail::hook<Engine, INSTRUMENTED_ENGINE != 0>;
+
+public:
+	using engine_type = Engine;
+	using result_type = typename Engine::result_type;
+
+	static constexpr result_type min() { return Engine::min(); }
+	static constexpr result_type max() { return Engine::max(); }
+	static constexpr result_type default_seed = Engine::default_seed;
+
+	explicit instrumented_engine(result_type value = default_seed)
+	{
+		seed(value);
+	}
+	instrumented_engine(instrument_channel &c, result_type value = default_seed) : hook(&c)
+	{
+		seed(value);
+	}
+	// counts from e's current position as if it had just been seeded
+	instrumented_engine(instrument_channel &c, const Engine &e) : hook(&c), eng(e) {}
+
+	void seed(result_type value = default_seed)
+	{
+		hook::seed(eng, value);
+	}
+	result_type operator()()
+	{
+		return hook::draw(eng);
+	}
+	void generate(result_type *first, result_type *last)
+	{
+		hook::bulk(eng, first, last);
+	}
+	void discard(unsigned long long z)
+	{
+		hook::skip(eng, z);
+	}
+
+	// nullptr when compiled out
+	instrument_channel* channel() const { return hook::channel(); }
+	const Engine& engine() const { return eng; }
+
+	friend bool operator==(const instrumented_engine &lhs, const instrumented_engine &rhs) { return lhs.eng == rhs.eng; }
+	friend bool operator!=(const instrumented_engine &lhs, const instrumented_engine &rhs) { return lhs.eng != rhs.eng; }
+	template <typename CharT, typename Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits> &os, const instrumented_engine &e)
+	{
+		return os << e.eng;
+	}
+	template <typename CharT, typename Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits> &is, instrumented_engine &e)
+	{
+		return is >> e.eng;
+	}
+
+private:
+	Engine eng;
+};
+
+#endif // INSTRUMENTED_ENGINE_H
@@ -1,9 +1,12 @@
 #ifndef ISAAC64_RANDOM_H
 #define ISAAC64_RANDOM_H
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <iosfwd>
+#include <iterator>
 #include <limits>
+#include "splitmix64_rand.hpp"
 
 /*
 ------------------------------------------------------------------------------
@@ -47,6 +50,48 @@ public:
 		}
 	}
 
+	// the same states as seed(values[i]) for each engine of [first, last),
+	// with the key scheduling of LANES engines interleaved
+	static void seed_many(isaac64_engine *first, isaac64_engine *last, const result_type *values)
+	{
+		while (first != last) {
+			const size_t n = std::min<size_t>(LANES, static_cast<size_t>(last - first));
+			ub8 v[LANES];
+			for (size_t k = 0; k < LANES; ++k) {
+				v[k] = values[k < n ? k : 0];
+			}
+			ub8 m[256][LANES];
+			randinit_lanes(v, m);
+			for (size_t k = 0; k < n; ++k) {
+				isaac64_engine &eng = first[k];
+				for (int i = 0; i < 256; ++i) {
+					eng.mm[i] = m[i][k];
+				}
+				eng.aa = eng.bb = eng.cc = 0;
+				eng.randcnt = 256;
+			}
+			isaac_lanes(first, n);
+			first += n;
+			values += n;
+		}
+	}
+	// a cheap alternative to seed() for many engines: prototype's pool xor-ed
+	// with a splitmix64 stream of key, then one isaac() pass. The result
+	// depends on both, so a per-job prototype and per-entity keys give
+	// distinct streams for every (job, entity).
+	void derive(const isaac64_engine &prototype, result_type key)
+	{
+		splitmix64_engine splitmix{ key };
+		for (size_t i = 0; i < mm.size(); ++i) {
+			mm[i] = prototype.mm[i] ^ splitmix();
+		}
+		aa = prototype.aa;
+		bb = prototype.bb;
+		cc = prototype.cc;
+		isaac();
+		randcnt = 256;
+	}
+
 	friend bool operator==(const isaac64_engine &, const isaac64_engine &);
 	friend std::ostream& operator<<(std::ostream &, const isaac64_engine &);
 	friend std::istream& operator>>(std::istream &, isaac64_engine &);
@@ -83,8 +128,45 @@ private:
 		}
 	}
 
+	enum : size_t { LANES = 4 };
+
+	// isaac() on engines [eng, eng + n), n <= LANES, with their dependency chains interleaved
+	static void isaac_lanes(isaac64_engine *eng, size_t n)
+	{
+		ub8 a[LANES], b[LANES];
+		for (size_t k = 0; k < n; ++k) {
+			eng[k].cc++;
+			a[k] = eng[k].aa;
+			b[k] = eng[k].bb + eng[k].cc;
+		}
+		for (int i = 0; i < 256; i += 4) {
+			for (size_t k = 0; k < n; ++k) {
+				ub8 &aa = a[k];
+				ub8 &bb = b[k];
+				auto &mm = eng[k].mm;
+				auto &randrsl = eng[k].randrsl;
+				for (int j = i; j < i + 4; ++j) {
+					const ub8 x = mm[j];
+					switch (j & 3) {
+					case 0: aa = ~(aa ^ (aa << 21)); break;
+					case 1: aa ^= aa >> 5;  break;
+					case 2: aa ^= aa << 12; break;
+					case 3: aa ^= aa >> 33; break;
+					}
+					aa += mm[(j + 128) & 255];
+					const ub8 y = mm[j] = mm[(x >> 2) & 255] + aa + bb;
+					randrsl[j] = bb = mm[(y >> 10) & 255] + x;
+				}
+			}
+		}
+		for (size_t k = 0; k < n; ++k) {
+			eng[k].aa = a[k];
+			eng[k].bb = b[k];
+		}
+	}
+
 	template <typename T>
-	inline void mix(T& a, T& b, T& c, T& d, T& e, T& f, T& g, T& h)
+	static void mix(T& a, T& b, T& c, T& d, T& e, T& f, T& g, T& h)
 	{
 		a -= e; f ^= h >> 9;  h += a;
 		b -= f; g ^= a << 9;  a += b;
@@ -129,6 +211,42 @@ private:
 		isaac();       // fill in the first set of results
 		randcnt = 256; // prepare to use the first set of results
 	}
+
+	// the pool randinit(true) computes from randrsl filled with v[k], for each k
+	static void randinit_lanes(const ub8 (&v)[LANES], ub8 (&m)[256][LANES])
+	{
+		ub8 x[8][LANES];
+		for (auto &row : x) {
+			std::fill(std::begin(row), std::end(row), 0x9e3779b97f4a7c13ULL);
+		}
+		for (int i = 0; i < 4; ++i) {
+			mix_lanes(x);
+		}
+		for (int i = 0; i < 256; i += 8) {
+			for (int j = 0; j < 8; ++j) {
+				for (size_t k = 0; k < LANES; ++k) {
+					x[j][k] += v[k];
+				}
+			}
+			mix_lanes(x);
+			std::copy(&x[0][0], &x[0][0] + 8 * LANES, &m[i][0]);
+		}
+		for (int i = 0; i < 256; i += 8) {
+			for (int j = 0; j < 8; ++j) {
+				for (size_t k = 0; k < LANES; ++k) {
+					x[j][k] += m[i + j][k];
+				}
+			}
+			mix_lanes(x);
+			std::copy(&x[0][0], &x[0][0] + 8 * LANES, &m[i][0]);
+		}
+	}
+	static void mix_lanes(ub8 (&x)[8][LANES])
+	{
+		for (size_t k = 0; k < LANES; ++k) {
+			mix(x[0][k], x[1][k], x[2][k], x[3][k], x[4][k], x[5][k], x[6][k], x[7][k]);
+		}
+	}
 };
 
 bool operator==(const isaac64_engine &lhs, const isaac64_engine &rhs)
@@ -153,7 +271,7 @@ std::ostream& operator<<(std::ostream &os, const isaac64_engine &eng)
 	for (auto value : eng.mm) {
 		os << value << ' ';
 	}
-	os << eng.aa << ' ' << eng.bb << ' ' << eng.cc;
+	return os << eng.aa << ' ' << eng.bb << ' ' << eng.cc;
 }
 std::istream& operator>>(std::istream &is, isaac64_engine &eng)
 {
@@ -164,7 +282,7 @@ std::istream& operator>>(std::istream &is, isaac64_engine &eng)
 	for (auto &value : eng.mm) {
 		is >> value;
 	}
-	is >> eng.aa >> eng.bb >> eng.cc;
+	return is >> eng.aa >> eng.bb >> eng.cc;
 }
 
 #endif // ISAAC64_RANDOM_H
@@ -1,9 +1,12 @@
 #ifndef ISAAC_RANDOM_H
 #define ISAAC_RANDOM_H
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <iosfwd>
+#include <iterator>
 #include <limits>
+#include "splitmix64_rand.hpp"
 
 /*
 ------------------------------------------------------------------------------
@@ -49,6 +52,50 @@ public:
 		}
 	}
 
+	// the same states as seed(values[i]) for each engine of [first, last),
+	// with the key scheduling of LANES engines interleaved
+	static void seed_many(isaac_engine *first, isaac_engine *last, const result_type *values)
+	{
+		while (first != last) {
+			const size_t n = std::min<size_t>(LANES, static_cast<size_t>(last - first));
+			ub4 v[LANES];
+			for (size_t k = 0; k < LANES; ++k) {
+				v[k] = values[k < n ? k : 0];
+			}
+			ub4 m[256][LANES];
+			randinit_lanes(v, m);
+			for (size_t k = 0; k < n; ++k) {
+				isaac_engine &eng = first[k];
+				for (int i = 0; i < 256; ++i) {
+					eng.mm[i] = m[i][k];
+				}
+				eng.aa = eng.bb = eng.cc = 0;
+				eng.randcnt = 256;
+			}
+			isaac_lanes(first, n);
+			first += n;
+			values += n;
+		}
+	}
+	// a cheap alternative to seed() for many engines: prototype's pool xor-ed
+	// with a splitmix64 stream of key, then one isaac() pass. The result
+	// depends on both, so a per-job prototype and per-entity keys give
+	// distinct streams for every (job, entity).
+	void derive(const isaac_engine &prototype, result_type key)
+	{
+		splitmix64_engine splitmix{ key };
+		for (size_t i = 0; i < mm.size(); i += 2) {
+			const uint64_t z = splitmix();
+			mm[i] = prototype.mm[i] ^ static_cast<ub4>(z);
+			mm[i + 1] = prototype.mm[i + 1] ^ static_cast<ub4>(z >> 32);
+		}
+		aa = prototype.aa;
+		bb = prototype.bb;
+		cc = prototype.cc;
+		isaac();
+		randcnt = 256;
+	}
+
 	friend bool operator==(const isaac_engine &, const isaac_engine &);
 	friend std::ostream& operator<<(std::ostream &, const isaac_engine &);
 	friend std::istream& operator>>(std::istream &, isaac_engine &);
@@ -85,8 +132,45 @@ private:
 		}
 	}
 
+	enum : size_t { LANES = 8 };
+
+	// isaac() on engines [eng, eng + n), n <= LANES, with their dependency chains interleaved
+	static void isaac_lanes(isaac_engine *eng, size_t n)
+	{
+		ub4 a[LANES], b[LANES];
+		for (size_t k = 0; k < n; ++k) {
+			eng[k].cc++;
+			a[k] = eng[k].aa;
+			b[k] = eng[k].bb + eng[k].cc;
+		}
+		for (int i = 0; i < 256; i += 4) {
+			for (size_t k = 0; k < n; ++k) {
+				ub4 &aa = a[k];
+				ub4 &bb = b[k];
+				auto &mm = eng[k].mm;
+				auto &randrsl = eng[k].randrsl;
+				for (int j = i; j < i + 4; ++j) {
+					const ub4 x = mm[j];
+					switch (j & 3) {
+					case 0: aa ^= aa << 13; break;
+					case 1: aa ^= aa >> 6;  break;
+					case 2: aa ^= aa << 2; break;
+					case 3: aa ^= aa >> 16; break;
+					}
+					aa += mm[(j + 128) & 255];
+					const ub4 y = mm[j] = mm[(x >> 2) & 255] + aa + bb;
+					randrsl[j] = bb = mm[(y >> 10) & 255] + x;
+				}
+			}
+		}
+		for (size_t k = 0; k < n; ++k) {
+			eng[k].aa = a[k];
+			eng[k].bb = b[k];
+		}
+	}
+
 	template <typename T>
-	inline void mix(T& a, T& b, T& c, T& d, T& e, T& f, T& g, T& h)
+	static void mix(T& a, T& b, T& c, T& d, T& e, T& f, T& g, T& h)
 	{
 		a ^= b << 11; d += a; b += c;
 		b ^= c >> 2;  e += b; c += d;
@@ -131,6 +215,42 @@ private:
 		isaac();       // fill in the first set of results
 		randcnt = 256; // prepare to use the first set of results
 	}
+
+	// the pool randinit(true) computes from randrsl filled with v[k], for each k
+	static void randinit_lanes(const ub4 (&v)[LANES], ub4 (&m)[256][LANES])
+	{
+		ub4 x[8][LANES];
+		for (auto &row : x) {
+			std::fill(std::begin(row), std::end(row), 0x9e3779b9);
+		}
+		for (int i = 0; i < 4; ++i) {
+			mix_lanes(x);
+		}
+		for (int i = 0; i < 256; i += 8) {
+			for (int j = 0; j < 8; ++j) {
+				for (size_t k = 0; k < LANES; ++k) {
+					x[j][k] += v[k];
+				}
+			}
+			mix_lanes(x);
+			std::copy(&x[0][0], &x[0][0] + 8 * LANES, &m[i][0]);
+		}
+		for (int i = 0; i < 256; i += 8) {
+			for (int j = 0; j < 8; ++j) {
+				for (size_t k = 0; k < LANES; ++k) {
+					x[j][k] += m[i + j][k];
+				}
+			}
+			mix_lanes(x);
+			std::copy(&x[0][0], &x[0][0] + 8 * LANES, &m[i][0]);
+		}
+	}
+	static void mix_lanes(ub4 (&x)[8][LANES])
+	{
+		for (size_t k = 0; k < LANES; ++k) {
+			mix(x[0][k], x[1][k], x[2][k], x[3][k], x[4][k], x[5][k], x[6][k], x[7][k]);
+		}
+	}
 };
 
 bool operator==(const isaac_engine &lhs, const isaac_engine &rhs)
@@ -155,7 +275,7 @@ std::ostream& operator<<(std::ostream &os, const isaac_engine &eng)
 	for (auto value : eng.mm) {
 		os << value << ' ';
 	}
-	os << eng.aa << ' ' << eng.bb << ' ' << eng.cc;
+	return os << eng.aa << ' ' << eng.bb << ' ' << eng.cc;
 }
 std::istream& operator>>(std::istream &is, isaac_engine &eng)
 {
@@ -166,7 +286,7 @@ std::istream& operator>>(std::istream &is, isaac_engine &eng)
 	for (auto &value : eng.mm) {
 		is >> value;
 	}
-	is >> eng.aa >> eng.bb >> eng.cc;
+	return is >> eng.aa >> eng.bb >> eng.cc;
 }
 
 #endif // ISAAC_RANDOM_H
@@ -1,9 +1,32 @@
 #ifndef JAVA_RANDOM_H
 #define JAVA_RANDOM_H
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iosfwd>
 #include <limits>
 #include <random>
+#include <stdexcept>
+#include "lcg_rand.hpp"
+#include "posix_rand.hpp"
+
+// nextGaussian() is specified with every product rounded. Contracting a * b + c
+// into one fma, which GCC does in every mode once the target has FMA and clang
+// does within an expression, changes its values, so contraction is turned off
+// for that code: by GCC on the whole function, by clang from the start of its body.
+#if defined(__GNUC__) && !defined(__clang__)
+#define JAVA_NO_CONTRACT __attribute__((optimize("fp-contract=off")))
+#define JAVA_NO_CONTRACT_BODY
+#elif defined(__clang__)
+#define JAVA_NO_CONTRACT
+#define JAVA_NO_CONTRACT_BODY _Pragma("clang fp contract(off)")
+#else
+#define JAVA_NO_CONTRACT
+#define JAVA_NO_CONTRACT_BODY
+#endif
 
 class java_engine // java.util.Random
 {
@@ -26,9 +49,21 @@ public:
 	{
 		return static_cast<result_type>((engine() & M48) >> SHIFT16);
 	}
+	// bulk output, same values as repeated operator()
+	void generate(result_type *first, result_type *last)
+	{
+		if (first == last) {
+			return;
+		}
+		const size_t n = static_cast<size_t>(last - first);
+		const uint64_t x = engine() & M48;
+		*first = static_cast<result_type>(x >> SHIFT16);
+		posix_detail::lcg48_fill(x, A, C, first + 1, n - 1, [](uint64_t y) { return static_cast<result_type>(y >> SHIFT16); });
+		lcg_discard(engine, n - 1);
+	}
 	void discard(unsigned long long z)
 	{
-		engine.discard(z);
+		lcg_discard(engine, z);
 	}
 
 	friend bool operator==(const java_engine &, const java_engine &);
@@ -58,4 +93,439 @@ std::istream& operator>>(std::istream &is, java_engine &eng)
 {
 	return is >> eng.engine;
 }
+
+class java_splittable_engine // java.util.SplittableRandom
+{
+public:
+	using result_type = uint64_t;
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	static constexpr result_type default_seed = 1;
+
+	explicit java_splittable_engine(result_type s = default_seed)
+	{
+		seed(s);
+	}
+	void seed(result_type s = default_seed)
+	{
+		x = s;
+		gamma = GOLDEN_GAMMA;
+	}
+	// nextLong()
+	result_type operator()()
+	{
+		return mix64(x += gamma);
+	}
+	// bulk output, same values as repeated operator()
+	void generate(result_type *first, result_type *last)
+	{
+		const size_t n = static_cast<size_t>(last - first);
+		for (size_t i = 0; i < n; ++i) {
+			first[i] = mix64(x + (i + 1) * gamma);
+		}
+		x += n * gamma;
+	}
+	void discard(unsigned long long z)
+	{
+		x += z * gamma; // Weyl sequence, O(1)
+	}
+	// the bits of nextInt(), which mixes the next seed differently from nextLong()
+	uint32_t next32()
+	{
+		return mix32(x += gamma);
+	}
+	// a new generator with its own seed and gamma, as SplittableRandom.split();
+	// advances this one by two values
+	java_splittable_engine split()
+	{
+		java_splittable_engine child;
+		child.x = (*this)();
+		child.gamma = mix_gamma(x += gamma);
+		return child;
+	}
+
+	friend bool operator==(const java_splittable_engine &, const java_splittable_engine &);
+	friend std::ostream& operator<<(std::ostream &, const java_splittable_engine &);
+	friend std::istream& operator>>(std::istream &, java_splittable_engine &);
+
+private:
+	enum : uint64_t { GOLDEN_GAMMA = 0x9E3779B97F4A7C15 };
+
+	uint64_t x;
+	uint64_t gamma; // odd
+
+	static uint64_t mix64(uint64_t z)
+	{
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+		return z ^ (z >> 31);
+	}
+	static uint32_t mix32(uint64_t z)
+	{
+		z = (z ^ (z >> 33)) * 0x62A9D9ED799705F5;
+		return static_cast<uint32_t>(((z ^ (z >> 28)) * 0xCB24D0A5C88C35B3) >> 32);
+	}
+	static uint64_t mix_gamma(uint64_t z)
+	{
+		z = (z ^ (z >> 33)) * 0xFF51AFD7ED558CCD;
+		z = (z ^ (z >> 33)) * 0xC4CEB9FE1A85EC53;
+		z = (z ^ (z >> 33)) | 1;
+		// too few bit transitions make a poor Weyl sequence
+		return std::bitset<64>(z ^ (z >> 1)).count() < 24 ? z ^ 0xAAAAAAAAAAAAAAAA : z;
+	}
+};
+
+bool operator==(const java_splittable_engine &lhs, const java_splittable_engine &rhs)
+{
+	return lhs.x == rhs.x && lhs.gamma == rhs.gamma;
+}
+bool operator!=(const java_splittable_engine &lhs, const java_splittable_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const java_splittable_engine &eng)
+{
+	return os << eng.x << ' ' << eng.gamma;
+}
+std::istream& operator>>(std::istream &is, java_splittable_engine &eng)
+{
+	return is >> eng.x >> eng.gamma;
+}
+
+namespace java_detail
+{
+	enum : size_t { CHUNK = 256 };
+
+	// StrictMath.log: fdlibm's __ieee754_log, which nextGaussian is specified with
+	//
+	// Copyright (C) 1993 by Sun Microsystems, Inc. All rights reserved.
+	//
+	// Developed at SunSoft, a Sun Microsystems, Inc. business.
+	// Permission to use, copy, modify, and distribute this
+	// software is freely granted, provided that this notice
+	// is preserved.
+	JAVA_NO_CONTRACT inline double strict_log(double x)
+	{
+		JAVA_NO_CONTRACT_BODY
+		const double ln2_hi = 6.93147180369123816490e-01, ln2_lo = 1.90821492927058770002e-10, two54 = 1.80143985094819840000e+16;
+		const double Lg1 = 6.666666666666735130e-01, Lg2 = 3.999999999940941908e-01, Lg3 = 2.857142874366239149e-01,
+			Lg4 = 2.222219843214978396e-01, Lg5 = 1.818357216161805012e-01, Lg6 = 1.531383769920937332e-01,
+			Lg7 = 1.479819860511658591e-01;
+
+		uint64_t bits;
+		std::memcpy(&bits, &x, sizeof bits);
+		int32_t hx = static_cast<int32_t>(bits >> 32);
+		const uint32_t lx = static_cast<uint32_t>(bits);
+		int32_t k = 0;
+		if (hx < 0x00100000) { // x < 2^-1022
+			if (((hx & 0x7FFFFFFF) | lx) == 0) {
+				return -std::numeric_limits<double>::infinity();
+			}
+			if (hx < 0) {
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+			k -= 54; // subnormal, scale up
+			x *= two54;
+			std::memcpy(&bits, &x, sizeof bits);
+			hx = static_cast<int32_t>(bits >> 32);
+		}
+		if (hx >= 0x7FF00000) {
+			return x + x;
+		}
+		k += (hx >> 20) - 1023;
+		hx &= 0x000FFFFF;
+		int32_t i = (hx + 0x95F64) & 0x100000;
+		bits = static_cast<uint64_t>(static_cast<uint32_t>(hx | (i ^ 0x3FF00000))) << 32 | (bits & 0xFFFFFFFF);
+		std::memcpy(&x, &bits, sizeof x); // normalize x or x/2
+		k += i >> 20;
+		const double f = x - 1.0;
+		const double dk = k;
+		if ((0x000FFFFF & (2 + hx)) < 3) { // |f| < 2^-20
+			if (f == 0.0) {
+				return k == 0 ? 0.0 : dk * ln2_hi + dk * ln2_lo;
+			}
+			const double R = f * f * (0.5 - 0.33333333333333333 * f);
+			return k == 0 ? f - R : dk * ln2_hi - ((R - dk * ln2_lo) - f);
+		}
+		const double s = f / (2.0 + f);
+		const double z = s * s;
+		const double w = z * z;
+		const double t1 = w * (Lg2 + w * (Lg4 + w * Lg6));
+		const double t2 = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+		const double R = t2 + t1;
+		i = (hx - 0x6147A) | (0x6B851 - hx);
+		if (i > 0) {
+			const double hfsq = 0.5 * f * f;
+			return k == 0 ? f - (hfsq - s * (hfsq + R)) : dk * ln2_hi - ((hfsq - (s * (hfsq + R) + dk * ln2_lo)) - f);
+		}
+		return k == 0 ? f - s * (f - R) : dk * ln2_hi - ((s * (f - R) - dk * ln2_lo) - f);
+	}
+
+	inline void check_bound(int32_t bound)
+	{
+		if (bound <= 0) {
+			throw std::invalid_argument("java: bound must be positive");
+		}
+	}
+
+	// Random.nextDouble() from next(32) values a, b: next(26) << 27 plus next(27), over 2^53
+	inline double to_double(uint32_t a, uint32_t b)
+	{
+		return static_cast<double>((static_cast<int64_t>(a >> 6) << 27) + (b >> 5)) * 0x1.0p-53;
+	}
+	// Random.nextLong(): next(32) << 32 plus the sign-extended next(32)
+	inline int64_t to_long(uint32_t a, uint32_t b)
+	{
+		return static_cast<int64_t>((static_cast<uint64_t>(a) << 32) + static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(b))));
+	}
+
+	// Random.nextInt(bound) on next(31) values u, for bounds that are not powers
+	// of 2: u % bound unless u falls in the last, partial, multiple of bound,
+	// which Java detects as u - r + bound - 1 overflowing an int
+	inline bool accept(uint32_t u, int32_t bound, int32_t &r)
+	{
+		r = static_cast<int32_t>(u % static_cast<uint32_t>(bound));
+		return static_cast<int32_t>(u - static_cast<uint32_t>(r) + static_cast<uint32_t>(bound - 1)) >= 0;
+	}
+	// SplittableRandom.nextInt(bound): the same on u >>> 1, summed in the other order
+	inline bool accept_splittable(uint32_t u, int32_t bound, int32_t &r)
+	{
+		r = static_cast<int32_t>(u % static_cast<uint32_t>(bound));
+		return static_cast<int32_t>(u + static_cast<uint32_t>(bound - 1) - static_cast<uint32_t>(r)) >= 0;
+	}
+}
+
+// The java.util.Random and java.util.SplittableRandom methods, bit-exact with
+// the JDK, on java_engine (whose raw output is Random.next(32)) and on
+// java_splittable_engine. The array forms give the values of as many calls in
+// a row; on java_engine the draws behind them are made in vectorizable blocks.
+// java::random adds the nextGaussian() cache that a Random object carries.
+//
+//   java_engine eng(42);                        // new Random(42)
+//   int32_t d = java::next_int(eng, 6);         // .nextInt(6)
+//   java::next_double(eng, v.data(), v.data() + v.size());
+//   java_splittable_engine root(seed), child = root.split();
+namespace java
+{
+	// nextInt()
+	inline int32_t next_int(java_engine &eng)
+	{
+		return static_cast<int32_t>(eng());
+	}
+	// nextInt(bound), [0, bound)
+	inline int32_t next_int(java_engine &eng, int32_t bound)
+	{
+		java_detail::check_bound(bound);
+		uint32_t u = eng() >> 1;
+		if ((bound & (bound - 1)) == 0) {
+			return static_cast<int32_t>(static_cast<int64_t>(bound) * u >> 31);
+		}
+		int32_t r;
+		while (!java_detail::accept(u, bound, r)) {
+			u = eng() >> 1;
+		}
+		return r;
+	}
+	// nextLong()
+	inline int64_t next_long(java_engine &eng)
+	{
+		const uint32_t a = eng();
+		return java_detail::to_long(a, eng());
+	}
+	// nextDouble(), [0, 1)
+	inline double next_double(java_engine &eng)
+	{
+		const uint32_t a = eng();
+		return java_detail::to_double(a, eng());
+	}
+
+	inline void next_int(java_engine &eng, int32_t *first, int32_t *last)
+	{
+		// int32_t may be accessed as its unsigned counterpart
+		eng.generate(reinterpret_cast<uint32_t *>(first), reinterpret_cast<uint32_t *>(last));
+	}
+	inline void next_int(java_engine &eng, int32_t bound, int32_t *first, int32_t *last)
+	{
+		java_detail::check_bound(bound);
+		uint32_t u[java_detail::CHUNK];
+		if ((bound & (bound - 1)) == 0) {
+			while (first != last) {
+				const size_t n = std::min<size_t>(java_detail::CHUNK, static_cast<size_t>(last - first));
+				eng.generate(u, u + n);
+				for (size_t i = 0; i < n; ++i) {
+					first[i] = static_cast<int32_t>(static_cast<int64_t>(bound) * (u[i] >> 1) >> 31);
+				}
+				first += n;
+			}
+			return;
+		}
+		// one draw per value still wanted: each is either accepted or rejected,
+		// so the engine is never advanced past the last draw the calls would make
+		while (first != last) {
+			const size_t n = std::min<size_t>(java_detail::CHUNK, static_cast<size_t>(last - first));
+			eng.generate(u, u + n);
+			for (size_t i = 0; i < n; ++i) {
+				first += java_detail::accept(u[i] >> 1, bound, *first);
+			}
+		}
+	}
+	inline void next_long(java_engine &eng, int64_t *first, int64_t *last)
+	{
+		uint32_t u[2 * java_detail::CHUNK];
+		while (first != last) {
+			const size_t n = std::min<size_t>(java_detail::CHUNK, static_cast<size_t>(last - first));
+			eng.generate(u, u + 2 * n);
+			for (size_t i = 0; i < n; ++i) {
+				first[i] = java_detail::to_long(u[2 * i], u[2 * i + 1]);
+			}
+			first += n;
+		}
+	}
+	inline void next_double(java_engine &eng, double *first, double *last)
+	{
+		uint32_t u[2 * java_detail::CHUNK];
+		while (first != last) {
+			const size_t n = std::min<size_t>(java_detail::CHUNK, static_cast<size_t>(last - first));
+			eng.generate(u, u + 2 * n);
+			for (size_t i = 0; i < n; ++i) {
+				first[i] = java_detail::to_double(u[2 * i], u[2 * i + 1]);
+			}
+			first += n;
+		}
+	}
+
+	// SplittableRandom
+	inline int32_t next_int(java_splittable_engine &eng)
+	{
+		return static_cast<int32_t>(eng.next32());
+	}
+	inline int32_t next_int(java_splittable_engine &eng, int32_t bound)
+	{
+		java_detail::check_bound(bound);
+		const uint32_t u = eng.next32();
+		if ((bound & (bound - 1)) == 0) {
+			return static_cast<int32_t>(u & static_cast<uint32_t>(bound - 1));
+		}
+		int32_t r;
+		for (uint32_t v = u >> 1; !java_detail::accept_splittable(v, bound, r); v = eng.next32() >> 1) {
+		}
+		return r;
+	}
+	inline int64_t next_long(java_splittable_engine &eng)
+	{
+		return static_cast<int64_t>(eng());
+	}
+	inline double next_double(java_splittable_engine &eng)
+	{
+		return static_cast<double>(eng() >> 11) * 0x1.0p-53;
+	}
+
+	inline void next_int(java_splittable_engine &eng, int32_t *first, int32_t *last)
+	{
+		std::generate(first, last, [&eng]() { return next_int(eng); });
+	}
+	inline void next_int(java_splittable_engine &eng, int32_t bound, int32_t *first, int32_t *last)
+	{
+		java_detail::check_bound(bound);
+		std::generate(first, last, [&eng, bound]() { return next_int(eng, bound); });
+	}
+	inline void next_long(java_splittable_engine &eng, int64_t *first, int64_t *last)
+	{
+		eng.generate(reinterpret_cast<uint64_t *>(first), reinterpret_cast<uint64_t *>(last));
+	}
+	inline void next_double(java_splittable_engine &eng, double *first, double *last)
+	{
+		uint64_t u[java_detail::CHUNK];
+		while (first != last) {
+			const size_t n = std::min<size_t>(java_detail::CHUNK, static_cast<size_t>(last - first));
+			eng.generate(u, u + n);
+			for (size_t i = 0; i < n; ++i) {
+				first[i] = static_cast<double>(u[i] >> 11) * 0x1.0p-53;
+			}
+			first += n;
+		}
+	}
+
+	// a java.util.Random object: the engine and the second value of the last
+	// nextGaussian() pair
+	class random
+	{
+	public:
+		explicit random(int64_t s) : eng(static_cast<uint64_t>(s)) {}
+
+		// setSeed(s)
+		void seed(int64_t s)
+		{
+			eng.seed(static_cast<uint64_t>(s));
+			have_next = false;
+		}
+
+		int32_t next_int() { return java::next_int(eng); }
+		int32_t next_int(int32_t bound) { return java::next_int(eng, bound); }
+		int64_t next_long() { return java::next_long(eng); }
+		double next_double() { return java::next_double(eng); }
+		// Marsaglia's polar method, two values per accepted pair
+		JAVA_NO_CONTRACT double next_gaussian()
+		{
+			JAVA_NO_CONTRACT_BODY
+			if (have_next) {
+				have_next = false;
+				return next;
+			}
+			double v1, v2, s;
+			do {
+				v1 = 2 * next_double() - 1;
+				v2 = 2 * next_double() - 1;
+				s = v1 * v1 + v2 * v2;
+			} while (s >= 1 || s == 0);
+			const double multiplier = std::sqrt(-2 * java_detail::strict_log(s) / s);
+			next = v2 * multiplier;
+			have_next = true;
+			return v1 * multiplier;
+		}
+
+		void next_int(int32_t *first, int32_t *last) { java::next_int(eng, first, last); }
+		void next_int(int32_t bound, int32_t *first, int32_t *last) { java::next_int(eng, bound, first, last); }
+		void next_long(int64_t *first, int64_t *last) { java::next_long(eng, first, last); }
+		void next_double(double *first, double *last) { java::next_double(eng, first, last); }
+		JAVA_NO_CONTRACT void next_gaussian(double *first, double *last)
+		{
+			JAVA_NO_CONTRACT_BODY
+			if (first != last && have_next) {
+				have_next = false;
+				*first++ = next;
+			}
+			// as with next_int(bound), only as many candidate pairs as values are
+			// still wanted: an accepted pair may give one more, which is kept
+			double v[4 * java_detail::CHUNK];
+			while (first != last) {
+				const size_t pairs = std::min<size_t>(java_detail::CHUNK, (static_cast<size_t>(last - first) + 1) / 2);
+				java::next_double(eng, v, v + 2 * pairs);
+				for (size_t i = 0; i < pairs; ++i) {
+					const double v1 = 2 * v[2 * i] - 1, v2 = 2 * v[2 * i + 1] - 1;
+					const double s = v1 * v1 + v2 * v2;
+					if (s >= 1 || s == 0) {
+						continue;
+					}
+					const double multiplier = std::sqrt(-2 * java_detail::strict_log(s) / s);
+					*first++ = v1 * multiplier;
+					if (first == last) {
+						next = v2 * multiplier;
+						have_next = true;
+					} else {
+						*first++ = v2 * multiplier;
+					}
+				}
+			}
+		}
+
+		java_engine& engine() { return eng; }
+
+	private:
+		java_engine eng;
+		double next = 0;
+		bool have_next = false;
+	};
+}
 #endif // JAVA_RANDOM_H
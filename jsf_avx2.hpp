@@ -0,0 +1,354 @@
+#ifndef JSF_AVX2_RANDOM_H
+#define JSF_AVX2_RANDOM_H
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <limits>
+#include "jsf32.hpp"
+#include "jsf64.hpp"
+
+/* A Small Noncryptographic PRNG by Bob Jenkins, several streams per vector */
+
+// Lane i is an independent jsf engine, a step advances all lanes at once.
+// Output n is lane n % LANES of step n / LANES, lane(i) returns the scalar
+// engine that reproduces lane i. Without AVX2 the lanes are stepped in a loop.
+
+class jsf32x8_engine // jsf32, 8 lanes
+{
+public:
+	using result_type = uint32_t;
+	enum : size_t { LANES = 8 };
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	static constexpr result_type default_seed = 1;
+
+	// lane i is seeded with value + i
+	explicit jsf32x8_engine(result_type value = default_seed)
+	{
+		seed(value);
+	}
+	void seed(result_type value = default_seed)
+	{
+		result_type seeds[LANES];
+		for (size_t i = 0; i < LANES; ++i) {
+			seeds[i] = value + static_cast<result_type>(i);
+		}
+		seed(seeds);
+	}
+	// same initialization as jsf32_engine::seed for every lane
+	void seed(const result_type (&seeds)[LANES])
+	{
+		for (size_t i = 0; i < LANES; ++i) {
+			x.a[i] = 0xf1ea5eed, x.b[i] = x.c[i] = x.d[i] = seeds[i];
+		}
+		for (int i = 0; i < 20; ++i) {
+			step(buf, 1);
+		}
+		pos = LANES;
+	}
+	result_type operator()()
+	{
+		if (pos == LANES) {
+			step(buf, 1);
+			pos = 0;
+		}
+		return buf[pos++];
+	}
+	// bulk output, same values as repeated operator()
+	void generate(result_type *first, result_type *last)
+	{
+		while (first != last && pos != LANES) {
+			*first++ = buf[pos++];
+		}
+		const size_t steps = static_cast<size_t>(last - first) / LANES;
+		step(first, steps);
+		first += steps * LANES;
+		while (first != last) {
+			*first++ = (*this)();
+		}
+	}
+	void discard(unsigned long long z)
+	{
+		while (z--) {
+			(*this)();
+		}
+	}
+
+	// the scalar engine that continues lane i from the current step
+	jsf32_engine lane(size_t i) const
+	{
+		const result_type state[4] = { x.a[i], x.b[i], x.c[i], x.d[i] };
+		jsf32_engine eng;
+		static_assert(sizeof eng == sizeof state, "jsf32_engine holds exactly a, b, c, d");
+		std::memcpy(&eng, state, sizeof state);
+		return eng;
+	}
+
+	friend bool operator==(const jsf32x8_engine &, const jsf32x8_engine &);
+	friend std::ostream& operator<<(std::ostream &, const jsf32x8_engine &);
+	friend std::istream& operator>>(std::istream &, jsf32x8_engine &);
+
+private:
+	struct ranctx { alignas(32) result_type a[LANES], b[LANES], c[LANES], d[LANES]; } x;
+	alignas(32) result_type buf[LANES];
+	size_t pos;
+
+	// advances every lane by steps, writing LANES outputs per step
+	void step(result_type *out, size_t steps)
+	{
+#if defined(__AVX2__)
+		__m256i a = _mm256_load_si256(reinterpret_cast<const __m256i *>(x.a));
+		__m256i b = _mm256_load_si256(reinterpret_cast<const __m256i *>(x.b));
+		__m256i c = _mm256_load_si256(reinterpret_cast<const __m256i *>(x.c));
+		__m256i d = _mm256_load_si256(reinterpret_cast<const __m256i *>(x.d));
+		for (; steps; --steps, out += LANES) {
+			const __m256i e = _mm256_sub_epi32(a, rotl<27>(b));
+			a = _mm256_xor_si256(b, rotl<17>(c));
+			b = _mm256_add_epi32(c, d);
+			c = _mm256_add_epi32(d, e);
+			d = _mm256_add_epi32(e, a);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(out), d);
+		}
+		_mm256_store_si256(reinterpret_cast<__m256i *>(x.a), a);
+		_mm256_store_si256(reinterpret_cast<__m256i *>(x.b), b);
+		_mm256_store_si256(reinterpret_cast<__m256i *>(x.c), c);
+		_mm256_store_si256(reinterpret_cast<__m256i *>(x.d), d);
+#else
+		for (; steps; --steps, out += LANES) {
+			for (size_t i = 0; i < LANES; ++i) {
+				const result_type e = x.a[i] - rotl(x.b[i], 27);
+				x.a[i] = x.b[i] ^ rotl(x.c[i], 17);
+				x.b[i] = x.c[i] + x.d[i];
+				x.c[i] = x.d[i] + e;
+				x.d[i] = e + x.a[i];
+				out[i] = x.d[i];
+			}
+		}
+#endif
+	}
+
+#if defined(__AVX2__)
+	template <int k>
+	static __m256i rotl(const __m256i v)
+	{
+		return _mm256_or_si256(_mm256_slli_epi32(v, k), _mm256_srli_epi32(v, 32 - k));
+	}
+#else
+	static uint32_t rotl(const uint32_t v, int k)
+	{
+		return (v << k) | (v >> (32 - k));
+	}
+#endif
+};
+
+bool operator==(const jsf32x8_engine &lhs, const jsf32x8_engine &rhs)
+{
+	return
+		std::memcmp(&lhs.x, &rhs.x, sizeof lhs.x) == 0 &&
+		lhs.pos == rhs.pos && // outputs already served do not count
+		std::memcmp(lhs.buf + lhs.pos, rhs.buf + rhs.pos, (lhs.LANES - lhs.pos) * sizeof lhs.buf[0]) == 0;
+}
+bool operator!=(const jsf32x8_engine &lhs, const jsf32x8_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const jsf32x8_engine &eng)
+{
+	for (size_t i = 0; i < jsf32x8_engine::LANES; ++i) {
+		os << eng.x.a[i] << ' ' << eng.x.b[i] << ' ' << eng.x.c[i] << ' ' << eng.x.d[i] << ' ';
+	}
+	for (auto value : eng.buf) {
+		os << value << ' ';
+	}
+	return os << eng.pos;
+}
+std::istream& operator>>(std::istream &is, jsf32x8_engine &eng)
+{
+	jsf32x8_engine next = eng;
+	for (size_t i = 0; i < jsf32x8_engine::LANES; ++i) {
+		is >> next.x.a[i] >> next.x.b[i] >> next.x.c[i] >> next.x.d[i];
+	}
+	for (auto &value : next.buf) {
+		is >> value;
+	}
+	if (!(is >> next.pos) || next.pos > jsf32x8_engine::LANES) {
+		is.setstate(std::ios_base::failbit);
+		return is;
+	}
+	eng = next;
+	return is;
+}
+
+class jsf64x4_engine // jsf64, 4 lanes
+{
+public:
+	using result_type = uint64_t;
+	enum : size_t { LANES = 4 };
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	static constexpr result_type default_seed = 1;
+
+	// lane i is seeded with value + i
+	explicit jsf64x4_engine(result_type value = default_seed)
+	{
+		seed(value);
+	}
+	void seed(result_type value = default_seed)
+	{
+		result_type seeds[LANES];
+		for (size_t i = 0; i < LANES; ++i) {
+			seeds[i] = value + i;
+		}
+		seed(seeds);
+	}
+	// same initialization as jsf64_engine::seed for every lane
+	void seed(const result_type (&seeds)[LANES])
+	{
+		for (size_t i = 0; i < LANES; ++i) {
+			x.a[i] = 0xf1ea5eed, x.b[i] = x.c[i] = x.d[i] = seeds[i];
+		}
+		for (int i = 0; i < 20; ++i) {
+			step(buf, 1);
+		}
+		pos = LANES;
+	}
+	result_type operator()()
+	{
+		if (pos == LANES) {
+			step(buf, 1);
+			pos = 0;
+		}
+		return buf[pos++];
+	}
+	// bulk output, same values as repeated operator()
+	void generate(result_type *first, result_type *last)
+	{
+		while (first != last && pos != LANES) {
+			*first++ = buf[pos++];
+		}
+		const size_t steps = static_cast<size_t>(last - first) / LANES;
+		step(first, steps);
+		first += steps * LANES;
+		while (first != last) {
+			*first++ = (*this)();
+		}
+	}
+	void discard(unsigned long long z)
+	{
+		while (z--) {
+			(*this)();
+		}
+	}
+
+	// the scalar engine that continues lane i from the current step
+	jsf64_engine lane(size_t i) const
+	{
+		const result_type state[4] = { x.a[i], x.b[i], x.c[i], x.d[i] };
+		jsf64_engine eng;
+		static_assert(sizeof eng == sizeof state, "jsf64_engine holds exactly a, b, c, d");
+		std::memcpy(&eng, state, sizeof state);
+		return eng;
+	}
+
+	friend bool operator==(const jsf64x4_engine &, const jsf64x4_engine &);
+	friend std::ostream& operator<<(std::ostream &, const jsf64x4_engine &);
+	friend std::istream& operator>>(std::istream &, jsf64x4_engine &);
+
+private:
+	struct ranctx { alignas(32) result_type a[LANES], b[LANES], c[LANES], d[LANES]; } x;
+	alignas(32) result_type buf[LANES];
+	size_t pos;
+
+	// advances every lane by steps, writing LANES outputs per step
+	void step(result_type *out, size_t steps)
+	{
+#if defined(__AVX2__)
+		__m256i a = _mm256_load_si256(reinterpret_cast<const __m256i *>(x.a));
+		__m256i b = _mm256_load_si256(reinterpret_cast<const __m256i *>(x.b));
+		__m256i c = _mm256_load_si256(reinterpret_cast<const __m256i *>(x.c));
+		__m256i d = _mm256_load_si256(reinterpret_cast<const __m256i *>(x.d));
+		for (; steps; --steps, out += LANES) {
+			const __m256i e = _mm256_sub_epi64(a, rotl<7>(b));
+			a = _mm256_xor_si256(b, rotl<13>(c));
+			b = _mm256_add_epi64(c, rotl<37>(d));
+			c = _mm256_add_epi64(d, e);
+			d = _mm256_add_epi64(e, a);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(out), d);
+		}
+		_mm256_store_si256(reinterpret_cast<__m256i *>(x.a), a);
+		_mm256_store_si256(reinterpret_cast<__m256i *>(x.b), b);
+		_mm256_store_si256(reinterpret_cast<__m256i *>(x.c), c);
+		_mm256_store_si256(reinterpret_cast<__m256i *>(x.d), d);
+#else
+		for (; steps; --steps, out += LANES) {
+			for (size_t i = 0; i < LANES; ++i) {
+				const result_type e = x.a[i] - rotl(x.b[i], 7);
+				x.a[i] = x.b[i] ^ rotl(x.c[i], 13);
+				x.b[i] = x.c[i] + rotl(x.d[i], 37);
+				x.c[i] = x.d[i] + e;
+				x.d[i] = e + x.a[i];
+				out[i] = x.d[i];
+			}
+		}
+#endif
+	}
+
+#if defined(__AVX2__)
+	template <int k>
+	static __m256i rotl(const __m256i v)
+	{
+		return _mm256_or_si256(_mm256_slli_epi64(v, k), _mm256_srli_epi64(v, 64 - k));
+	}
+#else
+	static uint64_t rotl(const uint64_t v, int k)
+	{
+		return (v << k) | (v >> (64 - k));
+	}
+#endif
+};
+
+bool operator==(const jsf64x4_engine &lhs, const jsf64x4_engine &rhs)
+{
+	return
+		std::memcmp(&lhs.x, &rhs.x, sizeof lhs.x) == 0 &&
+		lhs.pos == rhs.pos && // outputs already served do not count
+		std::memcmp(lhs.buf + lhs.pos, rhs.buf + rhs.pos, (lhs.LANES - lhs.pos) * sizeof lhs.buf[0]) == 0;
+}
+bool operator!=(const jsf64x4_engine &lhs, const jsf64x4_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const jsf64x4_engine &eng)
+{
+	for (size_t i = 0; i < jsf64x4_engine::LANES; ++i) {
+		os << eng.x.a[i] << ' ' << eng.x.b[i] << ' ' << eng.x.c[i] << ' ' << eng.x.d[i] << ' ';
+	}
+	for (auto value : eng.buf) {
+		os << value << ' ';
+	}
+	return os << eng.pos;
+}
+std::istream& operator>>(std::istream &is, jsf64x4_engine &eng)
+{
+	jsf64x4_engine next = eng;
+	for (size_t i = 0; i < jsf64x4_engine::LANES; ++i) {
+		is >> next.x.a[i] >> next.x.b[i] >> next.x.c[i] >> next.x.d[i];
+	}
+	for (auto &value : next.buf) {
+		is >> value;
+	}
+	if (!(is >> next.pos) || next.pos > jsf64x4_engine::LANES) {
+		is.setstate(std::ios_base::failbit);
+		return is;
+	}
+	eng = next;
+	return is;
+}
+
+#endif // JSF_AVX2_RANDOM_H
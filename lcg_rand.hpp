@@ -1,5 +1,6 @@
 #ifndef LCG_RAND_H
 #define LCG_RAND_H
+#include <cstdint>
 #include <random>
 
 // 32-bit
@@ -10,4 +11,30 @@ using msvc_lcg_engine = std::linear_congruential_engine<uint_fast32_t, 0x343FD,
 using mmix_lcg_engine = std::linear_congruential_engine<uint_fast64_t, 0x5851F42D4C957F2D, 0x14057B7EF767814F, 0>;
 using posix_lcg_engine = std::linear_congruential_engine<uint_fast64_t, 0x5DEECE66D, 0xB, 1ull << 48>; // slow...
 
+// advances a power-of-two modulus LCG by z steps in O(log z)
+// Brown, "Random Number Generation with Arbitrary Strides", 1994
+template <typename UIntType, UIntType a, UIntType c>
+void lcg_discard(std::linear_congruential_engine<UIntType, a, c, 0> &engine, unsigned long long z)
+{
+	if (!z--) {
+		return;
+	}
+	// the engine hides its state, one step exposes it
+	const UIntType x = engine();
+
+	// x_{n+z} = acc_mult * x_n + acc_plus
+	UIntType cur_mult = a, cur_plus = c;
+	UIntType acc_mult = 1, acc_plus = 0;
+	while (z) {
+		if (z & 1) {
+			acc_mult *= cur_mult;
+			acc_plus = acc_plus * cur_mult + cur_plus;
+		}
+		cur_plus = (cur_mult + 1) * cur_plus;
+		cur_mult *= cur_mult;
+		z >>= 1;
+	}
+	engine.seed(static_cast<UIntType>(acc_mult * x + acc_plus));
+}
+
 #endif // LCG_RAND_H
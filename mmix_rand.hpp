@@ -4,6 +4,7 @@
 #include <iosfwd>
 #include <limits>
 #include <random>
+#include "lcg_rand.hpp"
 
 class mmix_engine // Donald Knuth
 {
@@ -25,7 +26,7 @@ public:
 	}
 	void discard(unsigned long long z)
 	{
-		engine.discard(z);
+		lcg_discard(engine, z);
 	}
 
 	friend bool operator==(const mmix_engine &, const mmix_engine &);
@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <iosfwd>
 #include <random>
+#include "lcg_rand.hpp"
 
 class msvc_engine // MSVCRT
 {
@@ -29,7 +30,7 @@ public:
 	}
 	void discard(unsigned long long z)
 	{
-		engine.discard(z);
+		lcg_discard(engine, z);
 	}
 
 	friend bool operator==(const msvc_engine &, const msvc_engine &);
@@ -0,0 +1,249 @@
+#ifndef MT19937_RANDOM_H
+#define MT19937_RANDOM_H
+#if defined(__AVX2__)
+#define MT19937_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MT19937_SSE2
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+
+// Mersenne Twister with the state, output and stream format of std::mt19937.
+// The twist runs 4 (SSE2) or 8 (AVX2) words at a time, generate() tempers a
+// whole block at a time. Word i + 1 and word i + M are read before they are
+// rewritten, and the wrapped-around words i + M - N are at least N - M
+// behind, so every vector step only sees the values the scalar loop would.
+
+namespace mt19937_detail
+{
+#if defined(MT19937_AVX2)
+	struct vec
+	{
+		using type = __m256i;
+		enum : uint32_t { width = 8 };
+		static type load(const uint32_t *p) { return _mm256_loadu_si256(reinterpret_cast<const type *>(p)); }
+		static void store(uint32_t *p, type v) { _mm256_storeu_si256(reinterpret_cast<type *>(p), v); }
+		static type set1(uint32_t x) { return _mm256_set1_epi32(static_cast<int>(x)); }
+		static type and_(type a, type b) { return _mm256_and_si256(a, b); }
+		static type or_(type a, type b) { return _mm256_or_si256(a, b); }
+		static type xor_(type a, type b) { return _mm256_xor_si256(a, b); }
+		static type sub(type a, type b) { return _mm256_sub_epi32(a, b); }
+		template <int K> static type srl(type a) { return _mm256_srli_epi32(a, K); }
+		template <int K> static type sll(type a) { return _mm256_slli_epi32(a, K); }
+	};
+#elif defined(MT19937_SSE2)
+	struct vec
+	{
+		using type = __m128i;
+		enum : uint32_t { width = 4 };
+		static type load(const uint32_t *p) { return _mm_loadu_si128(reinterpret_cast<const type *>(p)); }
+		static void store(uint32_t *p, type v) { _mm_storeu_si128(reinterpret_cast<type *>(p), v); }
+		static type set1(uint32_t x) { return _mm_set1_epi32(static_cast<int>(x)); }
+		static type and_(type a, type b) { return _mm_and_si128(a, b); }
+		static type or_(type a, type b) { return _mm_or_si128(a, b); }
+		static type xor_(type a, type b) { return _mm_xor_si128(a, b); }
+		static type sub(type a, type b) { return _mm_sub_epi32(a, b); }
+		template <int K> static type srl(type a) { return _mm_srli_epi32(a, K); }
+		template <int K> static type sll(type a) { return _mm_slli_epi32(a, K); }
+	};
+#endif
+}
+
+class mt19937_engine // MT19937
+{
+public:
+	using result_type = uint32_t;
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	static constexpr result_type default_seed = 5489u;
+
+	explicit mt19937_engine(result_type value = default_seed)
+	{
+		seed(value);
+	}
+	void seed(result_type value = default_seed)
+	{
+		mt[0] = value;
+		for (uint32_t i = 1; i < N; ++i) {
+			mt[i] = 1812433253u * (mt[i - 1] ^ (mt[i - 1] >> 30)) + i;
+		}
+		idx = N;
+	}
+	// the same states as seed(values[i]) for each engine of [first, last),
+	// with the initialization recurrences of SEED_LANES engines interleaved
+	static void seed_many(mt19937_engine *first, mt19937_engine *last, const result_type *values)
+	{
+		while (first != last) {
+			const size_t n = std::min<size_t>(SEED_LANES, static_cast<size_t>(last - first));
+			uint32_t x[SEED_LANES];
+			for (size_t k = 0; k < SEED_LANES; ++k) {
+				x[k] = values[k < n ? k : 0];
+			}
+			for (uint32_t i = 1; i <= N; ++i) {
+				for (size_t k = 0; k < n; ++k) {
+					first[k].mt[i - 1] = x[k];
+				}
+				for (size_t k = 0; k < SEED_LANES; ++k) {
+					x[k] = 1812433253u * (x[k] ^ (x[k] >> 30)) + i;
+				}
+			}
+			for (size_t k = 0; k < n; ++k) {
+				first[k].idx = N;
+			}
+			first += n;
+			values += n;
+		}
+	}
+	result_type operator()()
+	{
+		if (idx >= N) {
+			twist();
+			idx = 0;
+		}
+		return temper(mt[idx++]);
+	}
+	// bulk output, same values as repeated operator()
+	void generate(result_type *first, result_type *last)
+	{
+		for (;;) {
+			const uint32_t n = static_cast<uint32_t>(std::min<size_t>(N - idx, last - first));
+			temper_block(first, mt + idx, n);
+			first += n;
+			idx += n;
+			if (first == last) {
+				break;
+			}
+			twist();
+			idx = 0;
+		}
+	}
+	void discard(unsigned long long z)
+	{
+		while (z > N - idx) {
+			z -= N - idx;
+			twist();
+			idx = 0;
+		}
+		idx += static_cast<uint32_t>(z);
+	}
+
+	friend bool operator==(const mt19937_engine &, const mt19937_engine &);
+	friend std::ostream& operator<<(std::ostream &, const mt19937_engine &);
+	friend std::istream& operator>>(std::istream &, mt19937_engine &);
+
+private:
+	enum : uint32_t { N = 624, M = 397, MATRIX_A = 0x9908b0df, UPPER_MASK = 0x80000000, LOWER_MASK = 0x7fffffff };
+	enum : size_t { SEED_LANES = 8 };
+
+	uint32_t mt[N];
+	uint32_t idx;
+
+	static uint32_t temper(uint32_t y)
+	{
+		y ^= y >> 11;
+		y ^= (y << 7) & 0x9d2c5680;
+		y ^= (y << 15) & 0xefc60000;
+		return y ^ (y >> 18);
+	}
+	static uint32_t twist_one(uint32_t cur, uint32_t next, uint32_t far)
+	{
+		const uint32_t y = (cur & UPPER_MASK) | (next & LOWER_MASK);
+		return far ^ (y >> 1) ^ ((0u - (y & 1)) & MATRIX_A);
+	}
+
+#if defined(MT19937_AVX2) || defined(MT19937_SSE2)
+	using vec = mt19937_detail::vec;
+
+	void twist()
+	{
+		const vec::type upper = vec::set1(UPPER_MASK), lower = vec::set1(LOWER_MASK);
+		const vec::type one = vec::set1(1), matrix = vec::set1(MATRIX_A), zero = vec::set1(0);
+		auto step = [&](uint32_t i, uint32_t j) {
+			const vec::type y = vec::or_(vec::and_(vec::load(mt + i), upper), vec::and_(vec::load(mt + i + 1), lower));
+			const vec::type mag = vec::and_(vec::sub(zero, vec::and_(y, one)), matrix);
+			vec::store(mt + i, vec::xor_(vec::xor_(vec::load(mt + j), vec::srl<1>(y)), mag));
+		};
+		constexpr uint32_t END1 = (N - M) / vec::width * vec::width;
+		constexpr uint32_t END2 = N - M + (M - 1) / vec::width * vec::width;
+		for (uint32_t i = 0; i < END1; i += vec::width) {
+			step(i, i + M);
+		}
+		for (uint32_t i = END1; i < N - M; ++i) {
+			mt[i] = twist_one(mt[i], mt[i + 1], mt[i + M]);
+		}
+		for (uint32_t i = N - M; i < END2; i += vec::width) {
+			step(i, i - (N - M));
+		}
+		for (uint32_t i = END2; i < N - 1; ++i) {
+			mt[i] = twist_one(mt[i], mt[i + 1], mt[i - (N - M)]);
+		}
+		mt[N - 1] = twist_one(mt[N - 1], mt[0], mt[M - 1]);
+	}
+	static void temper_block(uint32_t *out, const uint32_t *in, uint32_t n)
+	{
+		const vec::type b = vec::set1(0x9d2c5680), c = vec::set1(0xefc60000);
+		uint32_t i = 0;
+		for (; i + vec::width <= n; i += vec::width) {
+			vec::type y = vec::load(in + i);
+			y = vec::xor_(y, vec::srl<11>(y));
+			y = vec::xor_(y, vec::and_(vec::sll<7>(y), b));
+			y = vec::xor_(y, vec::and_(vec::sll<15>(y), c));
+			vec::store(out + i, vec::xor_(y, vec::srl<18>(y)));
+		}
+		for (; i < n; ++i) {
+			out[i] = temper(in[i]);
+		}
+	}
+#else
+	void twist()
+	{
+		uint32_t i = 0;
+		for (; i < N - M; ++i) {
+			mt[i] = twist_one(mt[i], mt[i + 1], mt[i + M]);
+		}
+		for (; i < N - 1; ++i) {
+			mt[i] = twist_one(mt[i], mt[i + 1], mt[i - (N - M)]);
+		}
+		mt[N - 1] = twist_one(mt[N - 1], mt[0], mt[M - 1]);
+	}
+	static void temper_block(uint32_t *out, const uint32_t *in, uint32_t n)
+	{
+		for (uint32_t i = 0; i < n; ++i) {
+			out[i] = temper(in[i]);
+		}
+	}
+#endif
+};
+
+bool operator==(const mt19937_engine &lhs, const mt19937_engine &rhs)
+{
+	return (lhs.idx == rhs.idx)
+		&& std::equal(std::begin(lhs.mt), std::end(lhs.mt), std::begin(rhs.mt));
+}
+bool operator!=(const mt19937_engine &lhs, const mt19937_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+// same text format as libstdc++ std::mt19937
+std::ostream& operator<<(std::ostream &os, const mt19937_engine &eng)
+{
+	for (auto value : eng.mt) {
+		os << value << ' ';
+	}
+	return os << eng.idx;
+}
+std::istream& operator>>(std::istream &is, mt19937_engine &eng)
+{
+	for (auto &value : eng.mt) {
+		is >> value;
+	}
+	return is >> eng.idx;
+}
+
+#endif // MT19937_RANDOM_H
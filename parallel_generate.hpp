@@ -0,0 +1,120 @@
+#ifndef PARALLEL_GENERATE_H
+#define PARALLEL_GENERATE_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "glibc_rand.hpp"
+#include "java_rand.hpp"
+#include "mmix_rand.hpp"
+#include "msvc_rand.hpp"
+#include "posix_rand.hpp"
+#include "splitmix64_rand.hpp"
+
+// Fills [first, last) from one engine on several threads with output that
+// does not depend on the number of threads.
+//
+// The range is cut into chunks of a fixed length. Chunk k starts from
+//  - the engine discarded by k * chunk values, for engines with a fast discard
+//    (splitmix64, SplittableRandom: O(1), LCG wrappers: O(log n)); the output
+//    is then exactly what a sequential loop over operator() would produce,
+//  - the engine jumped k times, for engines with jump() (xoshiro/xoroshiro);
+//    the output is the concatenation of the first chunk values of each
+//    jumped substream, so it depends on the chunk length.
+// On return the engine is positioned past everything it generated. A chunk
+// length of 0 throws std::invalid_argument.
+
+template <typename Engine>
+struct has_fast_discard : std::false_type {};
+
+template <> struct has_fast_discard<splitmix64_engine> : std::true_type {};
+template <> struct has_fast_discard<glibc_engine> : std::true_type {};
+template <> struct has_fast_discard<java_engine> : std::true_type {};
+template <> struct has_fast_discard<java_splittable_engine> : std::true_type {};
+template <> struct has_fast_discard<mmix_engine> : std::true_type {};
+template <> struct has_fast_discard<msvc_engine> : std::true_type {};
+template <> struct has_fast_discard<posix_engine> : std::true_type {};
+
+namespace parallel_generate_detail
+{
+	template <typename Engine, typename = void>
+	struct has_jump : std::false_type {};
+	template <typename Engine>
+	struct has_jump<Engine, decltype(std::declval<Engine &>().jump())> : std::true_type {};
+
+	enum : size_t { DEFAULT_CHUNK = 1 << 16 };
+}
+
+template <typename Engine, typename RandomIt>
+void parallel_generate(Engine &eng, RandomIt first, RandomIt last, unsigned threads,
+	size_t chunk = parallel_generate_detail::DEFAULT_CHUNK)
+{
+	using namespace parallel_generate_detail;
+	static_assert(has_fast_discard<Engine>::value || has_jump<Engine>::value,
+		"parallel_generate needs an engine with a fast discard() or a jump()");
+	if (chunk == 0) {
+		throw std::invalid_argument("parallel_generate: chunk must be positive");
+	}
+
+	const size_t size = static_cast<size_t>(last - first);
+	const size_t chunks = (size + chunk - 1) / chunk;
+
+	// chunk start states, cheap to compute serially
+	std::vector<Engine> start;
+	start.reserve(chunks + 1);
+	start.push_back(eng);
+	for (size_t k = 1; k <= chunks; ++k) {
+		Engine e = start.back();
+		if constexpr (has_fast_discard<Engine>::value) {
+			e.discard(k < chunks ? chunk : size - (chunks - 1) * chunk);
+		} else {
+			e.jump();
+		}
+		start.push_back(e);
+	}
+
+	// threads claim chunks from a shared counter, a fast thread takes over the rest
+	std::atomic<size_t> next{ 0 };
+	auto worker = [&]() {
+		for (size_t k; (k = next.fetch_add(1, std::memory_order_relaxed)) < chunks; ) {
+			Engine e = start[k];
+			const size_t begin = k * chunk, end = std::min(begin + chunk, size);
+			for (auto it = first + begin, stop = first + end; it != stop; ++it) {
+				*it = e();
+			}
+		}
+	};
+
+	threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(std::max<size_t>(chunks, 1))));
+	std::vector<std::thread> pool;
+	pool.reserve(threads - 1);
+	for (unsigned t = 1; t < threads; ++t) {
+		pool.emplace_back(worker);
+	}
+	worker();
+	for (auto &t : pool) {
+		t.join();
+	}
+
+	eng = start.back();
+}
+
+template <typename ExecutionPolicy, typename Engine, typename RandomIt,
+	typename = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+void parallel_generate(ExecutionPolicy &&, Engine &eng, RandomIt first, RandomIt last)
+{
+	unsigned threads = 1;
+	if constexpr (!std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::sequenced_policy>) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	parallel_generate(eng, first, last, threads);
+}
+
+#endif // PARALLEL_GENERATE_H
@@ -1,9 +1,108 @@
 #ifndef POSIX_RANDOM_H
 #define POSIX_RANDOM_H
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iosfwd>
 #include <limits>
 #include <random>
+#include "lcg_rand.hpp"
+
+namespace posix_detail
+{
+	enum : uint64_t { A = 0x5DEECE66D, C = 0xB, M48 = (1ull << 48) - 1 };
+	enum : size_t { LANES = 32, CHUNK = 512 };
+
+	// out[i] = convert(X_{i+1}) for i < n, X being x -> a x + c mod 2^48 from
+	// X_0 = x; returns X_n. Past the first LANES states each one is computed from
+	// the one LANES places earlier, a recurrence without short dependency chains,
+	// in whole chunks whose fixed trip counts vectorize even at -O2 (with AVX2;
+	// SSE2 has too few 64-bit lanes for the three products to pay).
+	template <typename T, typename Convert>
+	uint64_t lcg48_fill(uint64_t x, uint64_t a, uint64_t c, T *out, size_t n, Convert convert)
+	{
+		if (n < 2 * LANES) {
+			for (size_t i = 0; i < n; ++i) {
+				x = (a * x + c) & M48;
+				out[i] = convert(x);
+			}
+			return x;
+		}
+		uint64_t a_lanes = 1, c_lanes = 0;
+		for (size_t k = 0; k < LANES; ++k) {
+			a_lanes *= a;
+			c_lanes = a * c_lanes + c;
+		}
+#if defined(__AVX2__)
+		// a x mod 2^48 from 24-bit halves, 32 x 32 -> 64 bit products that SIMD units have
+		const uint32_t a_lo = static_cast<uint32_t>(a_lanes & 0xFFFFFF), a_hi = static_cast<uint32_t>(a_lanes >> 24 & 0xFFFFFF);
+		const uint64_t c48 = c_lanes & M48;
+#endif
+
+		uint64_t buf[LANES + CHUNK];
+		for (size_t i = 0; i < LANES; ++i) {
+			buf[i] = x = (a * x + c) & M48;
+			out[i] = convert(x);
+		}
+		out += LANES;
+		n -= LANES;
+		while (n) {
+			for (size_t i = 0; i < CHUNK; ++i) {
+#if defined(__AVX2__)
+				const uint32_t x_lo = static_cast<uint32_t>(buf[i] & 0xFFFFFF), x_hi = static_cast<uint32_t>(buf[i] >> 24);
+				const uint64_t mid = static_cast<uint64_t>(a_hi) * x_lo + static_cast<uint64_t>(a_lo) * x_hi;
+				buf[LANES + i] = (static_cast<uint64_t>(a_lo) * x_lo + (mid << 24) + c48) & M48;
+#else
+				buf[LANES + i] = (a_lanes * buf[i] + c_lanes) & M48;
+#endif
+			}
+			const size_t k = std::min<size_t>(CHUNK, n);
+			if (k == CHUNK) {
+				for (size_t i = 0; i < CHUNK; ++i) {
+					out[i] = convert(buf[LANES + i]);
+				}
+			} else {
+				for (size_t i = 0; i < k; ++i) {
+					out[i] = convert(buf[LANES + i]);
+				}
+			}
+			std::copy(buf + k, buf + k + LANES, buf);
+			out += k;
+			n -= k;
+		}
+		return buf[LANES - 1];
+	}
+
+	// the conversions of glibc: the state as the mantissa of a double in [1, 2) minus 1,
+	// which is exactly X / 2^48, and the high 31 or 32 bits
+	inline double to_double(uint64_t x)
+	{
+		const uint64_t bits = 0x3FF0000000000000ull | x << 4;
+		double d;
+		std::memcpy(&d, &bits, sizeof d);
+		return d - 1.0;
+	}
+	inline long to_nonnegative(uint64_t x)
+	{
+		return static_cast<long>(x >> 17);
+	}
+	inline long to_signed(uint64_t x)
+	{
+		return static_cast<long>(static_cast<int32_t>(static_cast<uint32_t>(x >> 16)));
+	}
+
+	inline uint64_t load(const unsigned short v[3])
+	{
+		return static_cast<uint64_t>(v[0]) | static_cast<uint64_t>(v[1]) << 16 | static_cast<uint64_t>(v[2]) << 32;
+	}
+	inline void store(unsigned short v[3], uint64_t x)
+	{
+		v[0] = static_cast<unsigned short>(x);
+		v[1] = static_cast<unsigned short>(x >> 16);
+		v[2] = static_cast<unsigned short>(x >> 32);
+	}
+}
 
 class posix_engine // IEEE Std 1003.1
 {
@@ -23,9 +122,20 @@ public:
 	{
 		return engine() & M48;
 	}
+	// bulk output, same values as repeated operator()
+	void generate(result_type *first, result_type *last)
+	{
+		if (first == last) {
+			return;
+		}
+		const size_t n = static_cast<size_t>(last - first);
+		const uint64_t x = *first = (*this)();
+		posix_detail::lcg48_fill(x, A, C, first + 1, n - 1, [](uint64_t y) { return y; });
+		lcg_discard(engine, n - 1);
+	}
 	void discard(unsigned long long z)
 	{
-		engine.discard(z);
+		lcg_discard(engine, z);
 	}
 
 	friend bool operator==(const posix_engine &, const posix_engine &);
@@ -58,8 +168,172 @@ std::istream& operator>>(std::istream &is, posix_engine &eng)
 
 namespace posix
 {
-	std::uniform_real_distribution<> drand48;
-	std::uniform_int_distribution<long> lrand48{ 0, std::numeric_limits<int>::max() };
-	std::uniform_int_distribution<long> mrand48{ std::numeric_limits<int>::min(), std::numeric_limits<int>::max() };
+	// multiplier and addend of the family, as set by lcong48
+	struct rand48_param
+	{
+		uint64_t a = posix_detail::A;
+		uint64_t c = posix_detail::C;
+	};
+}
+
+namespace posix_detail
+{
+	// convert(X) for the next last - first states of eng, which is advanced past them
+	template <typename T, typename Convert>
+	void engine_fill(posix_engine &eng, T *first, T *last, Convert convert)
+	{
+		if (first == last) {
+			return;
+		}
+		const size_t n = static_cast<size_t>(last - first);
+		const uint64_t x = eng();
+		*first = convert(x);
+		lcg48_fill(x, A, C, first + 1, n - 1, convert);
+		eng.discard(n - 1);
+	}
+
+	template <typename T, typename Convert>
+	void state_fill(unsigned short xsubi[3], const posix::rand48_param &p, T *first, T *last, Convert convert)
+	{
+		store(xsubi, lcg48_fill(load(xsubi), p.a, p.c, first, static_cast<size_t>(last - first), convert));
+	}
+
+	inline uint64_t step(unsigned short xsubi[3], const posix::rand48_param &p)
+	{
+		const uint64_t x = (p.a * load(xsubi) + p.c) & M48;
+		store(xsubi, x);
+		return x;
+	}
+}
+
+// The drand48 family, bit-exact with glibc. Given a posix_engine, drand48,
+// lrand48 and mrand48 are the values the C functions return after
+// srand48(seed); erand48, nrand48 and jrand48 work on caller-held state like
+// the C functions, and rand48 holds the rest of the family's state (seed48,
+// lcong48) per object instead of globally. The array forms give the values of
+// as many calls in a row, computed in vectorizable blocks.
+//
+//   posix_engine eng(seed);
+//   double x = posix::drand48(eng);             // drand48() after srand48(seed)
+//   posix::drand48(eng, v.data(), v.data() + v.size());
+//   unsigned short xsubi[3] = { ... };
+//   long r = posix::nrand48(xsubi);
+// Engines other than posix_engine keep the std::uniform_*_distribution
+// behaviour the distribution objects of this namespace used to have.
+namespace posix
+{
+	// [0, 1)
+	inline double drand48(posix_engine &eng)
+	{
+		return posix_detail::to_double(eng());
+	}
+	// [0, 2^31)
+	inline long lrand48(posix_engine &eng)
+	{
+		return posix_detail::to_nonnegative(eng());
+	}
+	// [-2^31, 2^31)
+	inline long mrand48(posix_engine &eng)
+	{
+		return posix_detail::to_signed(eng());
+	}
+
+	template <typename URBG>
+	double drand48(URBG &g)
+	{
+		return std::uniform_real_distribution<>{}(g);
+	}
+	template <typename URBG>
+	long lrand48(URBG &g)
+	{
+		return std::uniform_int_distribution<long>{ 0, std::numeric_limits<int>::max() }(g);
+	}
+	template <typename URBG>
+	long mrand48(URBG &g)
+	{
+		return std::uniform_int_distribution<long>{ std::numeric_limits<int>::min(), std::numeric_limits<int>::max() }(g);
+	}
+
+	inline void drand48(posix_engine &eng, double *first, double *last)
+	{
+		posix_detail::engine_fill(eng, first, last, [](uint64_t x) { return posix_detail::to_double(x); });
+	}
+	inline void lrand48(posix_engine &eng, long *first, long *last)
+	{
+		posix_detail::engine_fill(eng, first, last, [](uint64_t x) { return posix_detail::to_nonnegative(x); });
+	}
+	inline void mrand48(posix_engine &eng, long *first, long *last)
+	{
+		posix_detail::engine_fill(eng, first, last, [](uint64_t x) { return posix_detail::to_signed(x); });
+	}
+
+	// caller-held state, xsubi[0] holding the low 16 bits
+	inline double erand48(unsigned short xsubi[3], const rand48_param &p = {})
+	{
+		return posix_detail::to_double(posix_detail::step(xsubi, p));
+	}
+	inline long nrand48(unsigned short xsubi[3], const rand48_param &p = {})
+	{
+		return posix_detail::to_nonnegative(posix_detail::step(xsubi, p));
+	}
+	inline long jrand48(unsigned short xsubi[3], const rand48_param &p = {})
+	{
+		return posix_detail::to_signed(posix_detail::step(xsubi, p));
+	}
+
+	inline void erand48(unsigned short xsubi[3], double *first, double *last, const rand48_param &p = {})
+	{
+		posix_detail::state_fill(xsubi, p, first, last, [](uint64_t x) { return posix_detail::to_double(x); });
+	}
+	inline void nrand48(unsigned short xsubi[3], long *first, long *last, const rand48_param &p = {})
+	{
+		posix_detail::state_fill(xsubi, p, first, last, [](uint64_t x) { return posix_detail::to_nonnegative(x); });
+	}
+	inline void jrand48(unsigned short xsubi[3], long *first, long *last, const rand48_param &p = {})
+	{
+		posix_detail::state_fill(xsubi, p, first, last, [](uint64_t x) { return posix_detail::to_signed(x); });
+	}
+
+	// the hidden state of the C functions, one object per thread instead of a
+	// global; starts like glibc before any seeding, at X = 0
+	class rand48
+	{
+	public:
+		void srand48(long seedval)
+		{
+			posix_detail::store(x, static_cast<uint64_t>(static_cast<uint32_t>(seedval)) << 16 | 0x330E);
+			p = rand48_param();
+		}
+		// returns the previous state, valid until the next call
+		unsigned short* seed48(const unsigned short seed16v[3])
+		{
+			std::copy(x, x + 3, previous);
+			std::copy(seed16v, seed16v + 3, x);
+			p = rand48_param();
+			return previous;
+		}
+		void lcong48(const unsigned short param[7])
+		{
+			std::copy(param, param + 3, x);
+			p.a = posix_detail::load(param + 3);
+			p.c = param[6];
+		}
+
+		double drand48() { return erand48(x, p); }
+		long lrand48() { return nrand48(x, p); }
+		long mrand48() { return jrand48(x, p); }
+		void drand48(double *first, double *last) { erand48(x, first, last, p); }
+		void lrand48(long *first, long *last) { nrand48(x, first, last, p); }
+		void mrand48(long *first, long *last) { jrand48(x, first, last, p); }
+
+		// the multiplier and addend for erand48, nrand48 and jrand48 on caller-held
+		// state, which glibc takes from the hidden state too
+		const rand48_param& param() const { return p; }
+
+	private:
+		unsigned short x[3] = { 0, 0, 0 };
+		unsigned short previous[3] = { 0, 0, 0 };
+		rand48_param p;
+	};
 }
 #endif // POSIX_RANDOM_H
@@ -0,0 +1,119 @@
+#ifndef RAND_UTIL_H
+#define RAND_UTIL_H
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+// Helpers shared by the algorithms and distributions built on top of the engines.
+
+namespace rand_util
+{
+	// high 64 bits of a * b, low 64 bits in lo
+	inline uint64_t mulhi64(uint64_t a, uint64_t b, uint64_t &lo)
+	{
+#if defined(__SIZEOF_INT128__)
+		const unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+		lo = static_cast<uint64_t>(p);
+		return static_cast<uint64_t>(p >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		uint64_t hi;
+		lo = _umul128(a, b, &hi);
+		return hi;
+#else
+		const uint64_t a0 = a & 0xffffffff, a1 = a >> 32;
+		const uint64_t b0 = b & 0xffffffff, b1 = b >> 32;
+		const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+		const uint64_t mid = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+		lo = (mid << 32) | (p00 & 0xffffffff);
+		return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+	}
+
+	// number of uniform bits per call when max() - min() is 2^k - 1, 0 otherwise
+	template <typename URBG>
+	constexpr unsigned engine_bits()
+	{
+		using U = typename std::make_unsigned<typename URBG::result_type>::type;
+		const uint64_t range = static_cast<uint64_t>(static_cast<U>(URBG::max() - URBG::min()));
+		if (range & (range + 1)) {
+			return 0;
+		}
+		unsigned bits = 0;
+		for (uint64_t r = range; r; r >>= 1) {
+			++bits;
+		}
+		return bits;
+	}
+
+	// 64 uniform bits from any engine of the collection
+	template <typename URBG>
+	uint64_t word64(URBG &g)
+	{
+		constexpr unsigned bits = engine_bits<URBG>();
+		if constexpr (bits >= 64) {
+			return static_cast<uint64_t>(g() - URBG::min());
+		} else if constexpr (bits > 0) {
+			uint64_t w = 0;
+			for (unsigned n = 0; n < 64; n += bits) {
+				w = (w << bits) | static_cast<uint64_t>(g() - URBG::min());
+			}
+			return w;
+		} else {
+			return std::uniform_int_distribution<uint64_t>{}(g);
+		}
+	}
+
+	// uniform double in [0, 1) with 53 bits of precision
+	template <typename URBG>
+	double canonical(URBG &g)
+	{
+		return (word64(g) >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	// uniform integer in [0, range), range > 0
+	// Lemire, "Fast Random Integer Generation in an Interval", 2019
+	template <typename URBG>
+	uint64_t random_bounded(uint64_t range, URBG &g)
+	{
+		uint64_t lo, hi = mulhi64(word64(g), range, lo);
+		if (lo < range) {
+			const uint64_t t = (0 - range) % range;
+			while (lo < t) {
+				hi = mulhi64(word64(g), range, lo);
+			}
+		}
+		return hi;
+	}
+
+	// k uniform integers in [0, ranges[i]) from a single 64-bit word,
+	// the product of the ranges must be less than 2^64
+	// Brackett-Incorvaia, Lemire, "Batched Ranged Random Integer Generation", 2024
+	template <typename URBG>
+	void random_bounded_batch(const uint64_t *ranges, size_t k, uint64_t *result, URBG &g)
+	{
+		uint64_t product = 1;
+		for (size_t i = 0; i < k; ++i) {
+			product *= ranges[i];
+		}
+		uint64_t leftover = word64(g);
+		for (size_t i = 0; i < k; ++i) {
+			result[i] = mulhi64(leftover, ranges[i], leftover);
+		}
+		if (leftover < product) {
+			const uint64_t t = (0 - product) % product;
+			while (leftover < t) {
+				leftover = word64(g);
+				for (size_t i = 0; i < k; ++i) {
+					result[i] = mulhi64(leftover, ranges[i], leftover);
+				}
+			}
+		}
+	}
+}
+
+#endif // RAND_UTIL_H
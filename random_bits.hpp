@@ -0,0 +1,138 @@
+#ifndef RANDOM_BITS_H
+#define RANDOM_BITS_H
+#include <cmath>
+#include <cstdint>
+#include <iosfwd>
+#include <utility>
+#include "rand_util.hpp"
+
+// Hands out an engine's output a few bits at a time: single bits, n-bit fields
+// and exact Bernoulli(p) trials that usually consume CHUNK bits.
+
+template <typename Engine>
+class random_bits
+{
+public:
+	using engine_type = Engine;
+
+	static constexpr unsigned word_bits = rand_util::engine_bits<Engine>();
+	static_assert(word_bits > 0, "engine range must be a power of two");
+
+	random_bits() = default;
+	explicit random_bits(const Engine &e) : eng(e) {}
+	explicit random_bits(Engine &&e) : eng(std::move(e)) {}
+	template <typename Seed>
+	explicit random_bits(Seed s) : eng(s) {}
+
+	template <typename Seed>
+	void seed(Seed s)
+	{
+		eng.seed(s);
+		count = 0;
+	}
+	const Engine& base() const { return eng; }
+
+	bool bit()
+	{
+		if (!count) {
+			refill();
+		}
+		const bool b = cache & 1;
+		cache >>= 1;
+		--count;
+		return b;
+	}
+
+	// n uniform bits, n <= 64
+	uint64_t bits(unsigned n)
+	{
+		uint64_t result = 0;
+		unsigned have = 0;
+		while (have < n) {
+			if (!count) {
+				refill();
+			}
+			const unsigned take = n - have < count ? n - have : count;
+			result |= (cache & mask(take)) << have;
+			cache = take < 64 ? cache >> take : 0;
+			count -= take;
+			have += take;
+		}
+		return result;
+	}
+
+	// true with probability p, exact for every double p
+	// the uniform U is drawn CHUNK bits at a time and compared with the binary
+	// expansion of p, extending both only while they agree
+	bool bernoulli(double p)
+	{
+		if (!(p > 0)) {
+			return false;
+		}
+		if (p >= 1) {
+			return true;
+		}
+		double rest = p;
+		for (;;) {
+			rest = std::ldexp(rest, CHUNK);
+			const double digits = std::floor(rest);
+			rest -= digits; // exact
+			const uint64_t u = bits(CHUNK), d = static_cast<uint64_t>(digits);
+			if (u != d) {
+				return u < d;
+			}
+			if (rest == 0) { // the remaining bits of p are zero, U >= p
+				return false;
+			}
+		}
+	}
+
+	void discard(unsigned long long z)
+	{
+		while (z > count) {
+			z -= count;
+			refill();
+		}
+		cache = z < 64 ? cache >> z : 0;
+		count -= static_cast<unsigned>(z);
+	}
+
+	friend bool operator==(const random_bits &lhs, const random_bits &rhs)
+	{
+		return lhs.eng == rhs.eng && lhs.count == rhs.count && lhs.cache == rhs.cache;
+	}
+	friend bool operator!=(const random_bits &lhs, const random_bits &rhs)
+	{
+		return !(lhs == rhs);
+	}
+	template <typename CharT, typename Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits> &os, const random_bits &rb)
+	{
+		return os << rb.eng << ' ' << rb.cache << ' ' << rb.count;
+	}
+	template <typename CharT, typename Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits> &is, random_bits &rb)
+	{
+		return is >> rb.eng >> rb.cache >> rb.count;
+	}
+
+private:
+	enum : unsigned { CHUNK = 8 };
+
+	Engine eng;
+	uint64_t cache = 0;
+	unsigned count = 0;
+
+	static uint64_t mask(unsigned n)
+	{
+		return n < 64 ? (1ull << n) - 1 : ~0ull;
+	}
+
+	void refill()
+	{
+		cache = static_cast<uint64_t>(eng() - Engine::min());
+		count = word_bits < 64 ? word_bits : 64;
+	}
+};
+
+#endif // RANDOM_BITS_H
@@ -0,0 +1,220 @@
+#ifndef RANDOM_VIEW_H
+#define RANDOM_VIEW_H
+#include <version>
+#if !defined(__cpp_lib_ranges)
+#error "random_view.hpp needs C++20 ranges"
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include "rand_util.hpp"
+
+// Lazy input ranges over an engine:
+//   random_view(eng)                random_view(eng, n)           raw results
+//   random_view(eng, dist)          random_view(eng, dist, n)     dist(eng)
+//   random_bytes_view(eng)          random_bytes_view(eng, n)     bytes
+// The views refer to the engine and pull from it in batches of up to BATCH
+// values, with generate() when the engine or the distribution has one. An
+// unbounded view composes with std::views::take, but then the engine is
+// advanced by whole batches. A view with a count n draws exactly what the n
+// values need, and is a sized range, so containers built from it allocate
+// once: ranges::to in C++23, reserve(size()) and a copy before.
+//
+//   auto v = random_view(eng, fast_poisson_distribution<>(4.0), 1000) | std::ranges::to<std::vector>();
+//   for (double x : random_view(eng, dist) | std::views::transform(f) | std::views::take(10)) ...
+
+namespace random_view_detail
+{
+	enum : size_t { BATCH = 256 };
+
+	template <typename Engine>
+	concept bulk_engine = requires(Engine &eng, typename Engine::result_type *p) { eng.generate(p, p); };
+
+	template <typename Dist, typename Engine>
+	concept bulk_distribution = requires(Dist &dist, typename Dist::result_type *p, Engine &eng) { dist.generate(p, p, eng); };
+
+	// the engine's own results
+	struct raw_output {};
+
+	// single-pass range over a batch buffer refilled by Derived::produce(out, n)
+	template <typename Derived, typename T, bool Sized>
+	class batched_view : public std::ranges::view_interface<Derived>
+	{
+	public:
+		class iterator
+		{
+		public:
+			using iterator_concept = std::input_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using value_type = T;
+
+			iterator() = default;
+			explicit iterator(batched_view *parent) : parent(parent) {}
+
+			const T& operator*() const { return parent->buf[parent->pos]; }
+			iterator& operator++()
+			{
+				parent->next();
+				return *this;
+			}
+			void operator++(int) { ++*this; }
+
+			friend bool operator==(const iterator &it, std::default_sentinel_t) { return it.done(); }
+
+		private:
+			batched_view *parent = nullptr;
+
+			bool done() const { return parent->pos == parent->len; }
+		};
+
+		iterator begin()
+		{
+			if (pos == len) {
+				refill();
+			}
+			return iterator(this);
+		}
+		std::default_sentinel_t end() const { return std::default_sentinel; }
+
+		size_t size() const requires Sized { return count; }
+
+	protected:
+		batched_view() = default;
+		explicit batched_view(size_t count) : count(count), remaining(count) {}
+
+	private:
+		T buf[BATCH];
+		size_t pos = 0, len = 0;
+		size_t count = 0, remaining = 0; // Sized only
+
+		void next()
+		{
+			if (++pos == len) {
+				refill();
+			}
+		}
+		void refill()
+		{
+			size_t n = BATCH;
+			if constexpr (Sized) {
+				n = std::min<size_t>(n, remaining);
+				remaining -= n;
+			}
+			static_cast<Derived *>(this)->produce(buf, n);
+			pos = 0;
+			len = n;
+		}
+	};
+
+	template <typename Engine, typename Dist>
+	struct value_of
+	{
+		using type = typename Dist::result_type;
+	};
+	template <typename Engine>
+	struct value_of<Engine, raw_output>
+	{
+		using type = typename Engine::result_type;
+	};
+}
+
+template <typename Engine, typename Dist = random_view_detail::raw_output, bool Sized = false>
+class random_view
+	: public random_view_detail::batched_view<random_view<Engine, Dist, Sized>, typename random_view_detail::value_of<Engine, Dist>::type, Sized>
+{
+	using base = random_view_detail::batched_view<random_view, typename random_view_detail::value_of<Engine, Dist>::type, Sized>;
+	friend base;
+
+public:
+	using value_type = typename random_view_detail::value_of<Engine, Dist>::type;
+
+	random_view() = default;
+	explicit random_view(Engine &eng) requires (!Sized) : eng(&eng) {}
+	random_view(Engine &eng, size_t n) requires Sized : base(n), eng(&eng) {}
+	random_view(Engine &eng, Dist dist) requires (!Sized) : eng(&eng), dist(std::move(dist)) {}
+	random_view(Engine &eng, Dist dist, size_t n) requires Sized : base(n), eng(&eng), dist(std::move(dist)) {}
+
+	const Dist& distribution() const { return dist; }
+
+private:
+	Engine *eng = nullptr;
+	[[no_unique_address]] Dist dist;
+
+	void produce(value_type *out, size_t n)
+	{
+		using namespace random_view_detail;
+		if constexpr (std::is_same_v<Dist, raw_output>) {
+			if constexpr (bulk_engine<Engine>) {
+				eng->generate(out, out + n);
+			} else {
+				std::generate_n(out, n, std::ref(*eng));
+			}
+		} else if constexpr (bulk_distribution<Dist, Engine>) {
+			dist.generate(out, out + n, *eng);
+		} else {
+			for (size_t i = 0; i < n; ++i) {
+				out[i] = dist(*eng);
+			}
+		}
+	}
+};
+
+template <typename Engine>
+random_view(Engine &) -> random_view<Engine, random_view_detail::raw_output, false>;
+template <typename Engine, std::integral Count>
+random_view(Engine &, Count) -> random_view<Engine, random_view_detail::raw_output, true>;
+template <typename Engine, typename Dist>
+random_view(Engine &, Dist) -> random_view<Engine, Dist, false>;
+template <typename Engine, typename Dist, std::integral Count>
+random_view(Engine &, Dist, Count) -> random_view<Engine, Dist, true>;
+
+// Bytes of the native-endian results, or of rand_util::word64 for engines
+// with fewer than 32 or 64 significant bits.
+template <typename Engine, bool Sized = false>
+class random_bytes_view
+	: public random_view_detail::batched_view<random_bytes_view<Engine, Sized>, unsigned char, Sized>
+{
+	using base = random_view_detail::batched_view<random_bytes_view, unsigned char, Sized>;
+	friend base;
+
+public:
+	using value_type = unsigned char;
+
+	random_bytes_view() = default;
+	explicit random_bytes_view(Engine &eng) requires (!Sized) : eng(&eng) {}
+	random_bytes_view(Engine &eng, size_t n) requires Sized : base(n), eng(&eng) {}
+
+private:
+	using T = typename Engine::result_type;
+	static constexpr unsigned bits = rand_util::engine_bits<Engine>();
+	static constexpr bool full = bits == 8 * sizeof(T) && (bits == 32 || bits == 64);
+	using word_type = std::conditional_t<full, T, uint64_t>;
+
+	Engine *eng = nullptr;
+
+	void produce(unsigned char *out, size_t n)
+	{
+		word_type w[random_view_detail::BATCH / sizeof(word_type)];
+		const size_t words = (n + sizeof(word_type) - 1) / sizeof(word_type);
+		if constexpr (!full) {
+			std::generate_n(w, words, [this]() { return rand_util::word64(*eng); });
+		} else if constexpr (random_view_detail::bulk_engine<Engine>) {
+			eng->generate(w, w + words);
+		} else {
+			std::generate_n(w, words, std::ref(*eng));
+		}
+		std::memcpy(out, w, n);
+	}
+};
+
+template <typename Engine>
+random_bytes_view(Engine &) -> random_bytes_view<Engine, false>;
+template <typename Engine, std::integral Count>
+random_bytes_view(Engine &, Count) -> random_bytes_view<Engine, true>;
+
+#endif // RANDOM_VIEW_H
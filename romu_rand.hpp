@@ -0,0 +1,147 @@
+#ifndef ROMU_RANDOM_H
+#define ROMU_RANDOM_H
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include "splitmix64_rand.hpp"
+
+/* Romu Pseudorandom Number Generators by Mark A. Overton (Apache License 2.0) */
+
+// https://www.romu-random.org/
+
+namespace romu_detail
+{
+	inline uint64_t rotl(const uint64_t x, int k)
+	{
+#ifdef _MSC_VER
+		return _rotl64(x, k);
+#else
+		return (x << k) | (x >> (64 - k));
+#endif
+	}
+}
+
+class romu_trio_engine // RomuTrio
+{
+public:
+	using result_type = uint64_t;
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	static constexpr result_type default_seed = 1;
+
+	explicit romu_trio_engine(result_type value = default_seed)
+	{
+		seed(value);
+	}
+	void seed(result_type value = default_seed)
+	{
+		splitmix64_engine splitmix{ value };
+		x = splitmix();
+		y = splitmix();
+		z = splitmix();
+	}
+	result_type operator()()
+	{
+		using romu_detail::rotl;
+		const uint64_t xp = x, yp = y, zp = z;
+		x = 15241094284759029579u * zp;
+		y = rotl(yp - xp, 12);
+		z = rotl(zp - yp, 44);
+		return xp;
+	}
+	void discard(unsigned long long n)
+	{
+		while (n--) {
+			(*this)();
+		}
+	}
+
+	friend bool operator==(const romu_trio_engine &, const romu_trio_engine &);
+	friend std::ostream& operator<<(std::ostream &, const romu_trio_engine &);
+	friend std::istream& operator>>(std::istream &, romu_trio_engine &);
+
+private:
+	uint64_t x, y, z;
+};
+
+bool operator==(const romu_trio_engine &lhs, const romu_trio_engine &rhs)
+{
+	return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+}
+bool operator!=(const romu_trio_engine &lhs, const romu_trio_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const romu_trio_engine &eng)
+{
+	return os << eng.x << ' ' << eng.y << ' ' << eng.z;
+}
+std::istream& operator>>(std::istream &is, romu_trio_engine &eng)
+{
+	return is >> eng.x >> eng.y >> eng.z;
+}
+
+class romu_duo_jr_engine // RomuDuoJr
+{
+public:
+	using result_type = uint64_t;
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	static constexpr result_type default_seed = 1;
+
+	explicit romu_duo_jr_engine(result_type value = default_seed)
+	{
+		seed(value);
+	}
+	void seed(result_type value = default_seed)
+	{
+		splitmix64_engine splitmix{ value };
+		x = splitmix();
+		y = splitmix();
+	}
+	result_type operator()()
+	{
+		using romu_detail::rotl;
+		const uint64_t xp = x;
+		x = 15241094284759029579u * y;
+		y = rotl(y - xp, 27);
+		return xp;
+	}
+	void discard(unsigned long long n)
+	{
+		while (n--) {
+			(*this)();
+		}
+	}
+
+	friend bool operator==(const romu_duo_jr_engine &, const romu_duo_jr_engine &);
+	friend std::ostream& operator<<(std::ostream &, const romu_duo_jr_engine &);
+	friend std::istream& operator>>(std::istream &, romu_duo_jr_engine &);
+
+private:
+	uint64_t x, y;
+};
+
+bool operator==(const romu_duo_jr_engine &lhs, const romu_duo_jr_engine &rhs)
+{
+	return lhs.x == rhs.x && lhs.y == rhs.y;
+}
+bool operator!=(const romu_duo_jr_engine &lhs, const romu_duo_jr_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const romu_duo_jr_engine &eng)
+{
+	return os << eng.x << ' ' << eng.y;
+}
+std::istream& operator>>(std::istream &is, romu_duo_jr_engine &eng)
+{
+	return is >> eng.x >> eng.y;
+}
+
+#endif // ROMU_RANDOM_H
@@ -0,0 +1,81 @@
+#ifndef SEED_MANY_H
+#define SEED_MANY_H
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
+// Seeding many engines from per-entity keys.
+//
+// seed_many(first, last, keys) leaves engine i in the state of seed(keys[i]).
+// Engines with a static seed_many member interleave the initializations of
+// several engines (isaac, isaac64, mt19937); the others are seeded in a loop.
+//
+// derive_many(first, last, prototype, keys) gives engine i a state made from
+// the prototype's and keys[i], for engines with a derive() member that is
+// cheaper than seed() (isaac, isaac64). The others are seeded with keys[i],
+// which already is their cheapest start.
+
+namespace seed_many_detail
+{
+	template <typename Engine, typename = void>
+	struct has_seed_many : std::false_type {};
+	template <typename Engine>
+	struct has_seed_many<Engine, decltype(Engine::seed_many(std::declval<Engine *>(), std::declval<Engine *>(),
+		std::declval<const typename Engine::result_type *>()))> : std::true_type {};
+
+	template <typename Engine, typename = void>
+	struct has_derive : std::false_type {};
+	template <typename Engine>
+	struct has_derive<Engine, decltype(std::declval<Engine &>().derive(std::declval<const Engine &>(),
+		std::declval<typename Engine::result_type>()))> : std::true_type {};
+}
+
+template <typename Engine>
+void seed_many(Engine *first, Engine *last, const typename Engine::result_type *keys)
+{
+	if constexpr (seed_many_detail::has_seed_many<Engine>::value) {
+		Engine::seed_many(first, last, keys);
+	} else {
+		for (; first != last; ++first) {
+			first->seed(*keys++);
+		}
+	}
+}
+
+template <typename Engine>
+void derive_many(Engine *first, Engine *last, const Engine &prototype, const typename Engine::result_type *keys)
+{
+	for (; first != last; ++first) {
+		if constexpr (seed_many_detail::has_derive<Engine>::value) {
+			first->derive(prototype, *keys++);
+		} else {
+			first->seed(*keys++);
+		}
+	}
+}
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+template <typename Engine>
+void seed_many(std::span<Engine> engines, std::span<const typename Engine::result_type> keys)
+{
+	if (keys.size() < engines.size()) {
+		throw std::invalid_argument("seed_many: fewer keys than engines");
+	}
+	seed_many(engines.data(), engines.data() + engines.size(), keys.data());
+}
+
+template <typename Engine>
+void derive_many(std::span<Engine> engines, const Engine &prototype, std::span<const typename Engine::result_type> keys)
+{
+	if (keys.size() < engines.size()) {
+		throw std::invalid_argument("derive_many: fewer keys than engines");
+	}
+	derive_many(engines.data(), engines.data() + engines.size(), prototype, keys.data());
+}
+#endif
+
+#endif // SEED_MANY_H
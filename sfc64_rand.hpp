@@ -0,0 +1,88 @@
+#ifndef SFC64_RANDOM_H
+#define SFC64_RANDOM_H
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include "splitmix64_rand.hpp"
+
+/* Small Fast Chaotic PRNG by Chris Doty-Humphrey, from PractRand (public domain) */
+
+// http://pracrand.sourceforge.net/
+
+class sfc64_engine // sfc64
+{
+public:
+	using result_type = uint64_t;
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	static constexpr result_type default_seed = 1;
+
+	explicit sfc64_engine(result_type value = default_seed)
+	{
+		seed(value);
+	}
+	void seed(result_type value = default_seed)
+	{
+		splitmix64_engine splitmix{ value };
+		a = splitmix();
+		b = splitmix();
+		c = splitmix();
+		counter = 1;
+		for (int i = 0; i < 12; ++i) {
+			(*this)();
+		}
+	}
+	result_type operator()()
+	{
+		const uint64_t tmp = a + b + counter++;
+		a = b ^ (b >> 11);
+		b = c + (c << 3);
+		c = rotl(c, 24) + tmp;
+		return tmp;
+	}
+	void discard(unsigned long long z)
+	{
+		while (z--) {
+			(*this)();
+		}
+	}
+
+	friend bool operator==(const sfc64_engine &, const sfc64_engine &);
+	friend std::ostream& operator<<(std::ostream &, const sfc64_engine &);
+	friend std::istream& operator>>(std::istream &, sfc64_engine &);
+
+private:
+	static uint64_t rotl(const uint64_t x, int k)
+	{
+#ifdef _MSC_VER
+		return _rotl64(x, k);
+#else
+		return (x << k) | (x >> (64 - k));
+#endif
+	}
+
+	uint64_t a, b, c, counter;
+};
+
+bool operator==(const sfc64_engine &lhs, const sfc64_engine &rhs)
+{
+	return lhs.a == rhs.a && lhs.b == rhs.b && lhs.c == rhs.c && lhs.counter == rhs.counter;
+}
+bool operator!=(const sfc64_engine &lhs, const sfc64_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const sfc64_engine &eng)
+{
+	return os << eng.a << ' ' << eng.b << ' ' << eng.c << ' ' << eng.counter;
+}
+std::istream& operator>>(std::istream &is, sfc64_engine &eng)
+{
+	return is >> eng.a >> eng.b >> eng.c >> eng.counter;
+}
+
+#endif // SFC64_RANDOM_H
@@ -0,0 +1,413 @@
+#ifndef SFMT_RANDOM_H
+#define SFMT_RANDOM_H
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SFMT_SSE2
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <limits>
+
+/*
+Copyright (c) 2006,2007 Mutsuo Saito, Makoto Matsumoto and Hiroshima
+University.
+Copyright (c) 2012 Mutsuo Saito, Makoto Matsumoto, Hiroshima University
+and The University of Tokyo.
+All rights reserved. (BSD-3-Clause)
+*/
+
+// http://www.math.sci.hiroshima-u.ac.jp/m-mat/MT/SFMT/index.html
+
+// The state is refreshed a whole block at a time with the SSE2 recursion,
+// generate() copies whole blocks. Each 128-bit step depends on the two
+// previous ones, so wider vectors do not help.
+
+class sfmt19937_engine // SFMT19937
+{
+public:
+	using result_type = uint32_t;
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	static constexpr result_type default_seed = 1;
+
+	explicit sfmt19937_engine(result_type value = default_seed)
+	{
+		seed(value);
+	}
+	void seed(result_type value = default_seed) // init_gen_rand
+	{
+		state[0] = value;
+		for (uint32_t i = 1; i < N32; ++i) {
+			state[i] = 1812433253u * (state[i - 1] ^ (state[i - 1] >> 30)) + i;
+		}
+		idx = N32;
+		period_certification();
+	}
+	result_type operator()()
+	{
+		if (idx >= N32) {
+			gen_rand_all();
+			idx = 0;
+		}
+		return state[idx++];
+	}
+	// bulk output, same values as repeated operator()
+	void generate(result_type *first, result_type *last)
+	{
+		for (;;) {
+			const size_t n = std::min<size_t>(N32 - idx, last - first);
+			std::memcpy(first, state + idx, n * sizeof(result_type));
+			first += n;
+			idx += static_cast<uint32_t>(n);
+			if (first == last) {
+				break;
+			}
+			gen_rand_all();
+			idx = 0;
+		}
+	}
+	void discard(unsigned long long z)
+	{
+		while (z > N32 - idx) {
+			z -= N32 - idx;
+			gen_rand_all();
+			idx = 0;
+		}
+		idx += static_cast<uint32_t>(z);
+	}
+
+	friend bool operator==(const sfmt19937_engine &, const sfmt19937_engine &);
+	friend std::ostream& operator<<(std::ostream &, const sfmt19937_engine &);
+	friend std::istream& operator>>(std::istream &, sfmt19937_engine &);
+
+private:
+	enum : uint32_t { N = 156, N32 = N * 4, POS1 = 122, SL1 = 18, SL2 = 1, SR1 = 11, SR2 = 1 };
+	enum : uint32_t { MSK1 = 0xdfffffef, MSK2 = 0xddfecb7f, MSK3 = 0xbffaffff, MSK4 = 0xbffffff6 };
+	enum : uint32_t { PARITY1 = 0x00000001, PARITY2 = 0x00000000, PARITY3 = 0x00000000, PARITY4 = 0x13c9e684 };
+
+	alignas(16) uint32_t state[N32];
+	uint32_t idx;
+
+	void period_certification()
+	{
+		const uint32_t parity[4] = { PARITY1, PARITY2, PARITY3, PARITY4 };
+		uint32_t inner = 0;
+		for (int i = 0; i < 4; ++i) {
+			inner ^= state[i] & parity[i];
+		}
+		for (int i = 16; i > 0; i >>= 1) {
+			inner ^= inner >> i;
+		}
+		if (inner & 1) {
+			return;
+		}
+		for (int i = 0; i < 4; ++i) {
+			for (uint32_t work = 1; work; work <<= 1) {
+				if (work & parity[i]) {
+					state[i] ^= work;
+					return;
+				}
+			}
+		}
+	}
+
+#if defined(SFMT_SSE2)
+	static __m128i recursion(__m128i a, __m128i b, __m128i c, __m128i d, __m128i mask)
+	{
+		__m128i y = _mm_srli_epi32(b, SR1);
+		__m128i z = _mm_srli_si128(c, SR2);
+		const __m128i v = _mm_slli_epi32(d, SL1);
+		z = _mm_xor_si128(z, a);
+		z = _mm_xor_si128(z, v);
+		const __m128i x = _mm_slli_si128(a, SL2);
+		y = _mm_and_si128(y, mask);
+		z = _mm_xor_si128(z, x);
+		return _mm_xor_si128(z, y);
+	}
+
+	void gen_rand_all()
+	{
+		__m128i *s = reinterpret_cast<__m128i *>(state);
+		const __m128i mask = _mm_set_epi32(MSK4, MSK3, MSK2, MSK1);
+		__m128i r1 = _mm_load_si128(s + N - 2);
+		__m128i r2 = _mm_load_si128(s + N - 1);
+		uint32_t i = 0;
+		for (; i < N - POS1; ++i) {
+			const __m128i r = recursion(_mm_load_si128(s + i), _mm_load_si128(s + i + POS1), r1, r2, mask);
+			_mm_store_si128(s + i, r);
+			r1 = r2;
+			r2 = r;
+		}
+		for (; i < N; ++i) {
+			const __m128i r = recursion(_mm_load_si128(s + i), _mm_load_si128(s + i + POS1 - N), r1, r2, mask);
+			_mm_store_si128(s + i, r);
+			r1 = r2;
+			r2 = r;
+		}
+	}
+#else
+	// 128-bit shifts by whole bytes, words in little endian order
+	static void lshift128(uint32_t *out, const uint32_t *in, int shift)
+	{
+		const uint64_t th = (static_cast<uint64_t>(in[3]) << 32) | in[2];
+		const uint64_t tl = (static_cast<uint64_t>(in[1]) << 32) | in[0];
+		const uint64_t oh = (th << (shift * 8)) | (tl >> (64 - shift * 8));
+		const uint64_t ol = tl << (shift * 8);
+		out[1] = static_cast<uint32_t>(ol >> 32);
+		out[0] = static_cast<uint32_t>(ol);
+		out[3] = static_cast<uint32_t>(oh >> 32);
+		out[2] = static_cast<uint32_t>(oh);
+	}
+	static void rshift128(uint32_t *out, const uint32_t *in, int shift)
+	{
+		const uint64_t th = (static_cast<uint64_t>(in[3]) << 32) | in[2];
+		const uint64_t tl = (static_cast<uint64_t>(in[1]) << 32) | in[0];
+		const uint64_t oh = th >> (shift * 8);
+		const uint64_t ol = (tl >> (shift * 8)) | (th << (64 - shift * 8));
+		out[1] = static_cast<uint32_t>(ol >> 32);
+		out[0] = static_cast<uint32_t>(ol);
+		out[3] = static_cast<uint32_t>(oh >> 32);
+		out[2] = static_cast<uint32_t>(oh);
+	}
+	static void recursion(uint32_t *r, const uint32_t *a, const uint32_t *b, const uint32_t *c, const uint32_t *d)
+	{
+		const uint32_t mask[4] = { MSK1, MSK2, MSK3, MSK4 };
+		uint32_t x[4], y[4];
+		lshift128(x, a, SL2);
+		rshift128(y, c, SR2);
+		for (int k = 0; k < 4; ++k) {
+			r[k] = a[k] ^ x[k] ^ ((b[k] >> SR1) & mask[k]) ^ y[k] ^ (d[k] << SL1);
+		}
+	}
+
+	void gen_rand_all()
+	{
+		const uint32_t *r1 = state + 4 * (N - 2);
+		const uint32_t *r2 = state + 4 * (N - 1);
+		uint32_t i = 0;
+		for (; i < N - POS1; ++i) {
+			recursion(state + 4 * i, state + 4 * i, state + 4 * (i + POS1), r1, r2);
+			r1 = r2;
+			r2 = state + 4 * i;
+		}
+		for (; i < N; ++i) {
+			recursion(state + 4 * i, state + 4 * i, state + 4 * (i + POS1 - N), r1, r2);
+			r1 = r2;
+			r2 = state + 4 * i;
+		}
+	}
+#endif
+};
+
+bool operator==(const sfmt19937_engine &lhs, const sfmt19937_engine &rhs)
+{
+	return (lhs.idx == rhs.idx)
+		&& std::equal(std::begin(lhs.state), std::end(lhs.state), std::begin(rhs.state));
+}
+bool operator!=(const sfmt19937_engine &lhs, const sfmt19937_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const sfmt19937_engine &eng)
+{
+	for (auto value : eng.state) {
+		os << value << ' ';
+	}
+	return os << eng.idx;
+}
+std::istream& operator>>(std::istream &is, sfmt19937_engine &eng)
+{
+	for (auto &value : eng.state) {
+		is >> value;
+	}
+	return is >> eng.idx;
+}
+
+// dSFMT produces doubles in [1, 2) directly, operator() returns their
+// 52 mantissa bits and next_double() / generate() the doubles in [0, 1).
+
+class dsfmt19937_engine // dSFMT19937
+{
+public:
+	using result_type = uint64_t;
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return LOW_MASK; }
+	static constexpr result_type default_seed = 1;
+
+	explicit dsfmt19937_engine(uint32_t value = default_seed)
+	{
+		seed(value);
+	}
+	void seed(uint32_t value = default_seed) // dsfmt_init_gen_rand
+	{
+		uint32_t *psfmt = reinterpret_cast<uint32_t *>(state);
+		psfmt[0] = value;
+		for (uint32_t i = 1; i < (N + 1) * 4; ++i) {
+			psfmt[i] = 1812433253u * (psfmt[i - 1] ^ (psfmt[i - 1] >> 30)) + i;
+		}
+		for (uint32_t i = 0; i < N64; ++i) { // initial_mask
+			state[i] = (state[i] & LOW_MASK) | HIGH_CONST;
+		}
+		period_certification();
+		idx = N64;
+	}
+	result_type operator()()
+	{
+		return next() & LOW_MASK;
+	}
+	// [0, 1)
+	double next_double()
+	{
+		return to_double(next()) - 1.0;
+	}
+	// bulk [0, 1), same values as repeated next_double()
+	void generate(double *first, double *last)
+	{
+		for (;;) {
+			const size_t n = std::min<size_t>(N64 - idx, last - first);
+			for (size_t i = 0; i < n; ++i) {
+				first[i] = to_double(state[idx + i]) - 1.0;
+			}
+			first += n;
+			idx += static_cast<uint32_t>(n);
+			if (first == last) {
+				break;
+			}
+			gen_rand_all();
+			idx = 0;
+		}
+	}
+	void discard(unsigned long long z)
+	{
+		while (z > N64 - idx) {
+			z -= N64 - idx;
+			gen_rand_all();
+			idx = 0;
+		}
+		idx += static_cast<uint32_t>(z);
+	}
+
+	friend bool operator==(const dsfmt19937_engine &, const dsfmt19937_engine &);
+	friend std::ostream& operator<<(std::ostream &, const dsfmt19937_engine &);
+	friend std::istream& operator>>(std::istream &, dsfmt19937_engine &);
+
+private:
+	enum : uint32_t { N = 191, N64 = N * 2, POS1 = 117, SL1 = 19, SR = 12 };
+	enum : uint64_t { MSK1 = 0x000ffafffffffb3f, MSK2 = 0x000ffdfffc90fffd };
+	enum : uint64_t { FIX1 = 0x90014964b32f4329, FIX2 = 0x3b8d12ac548a7c7a };
+	enum : uint64_t { PCV1 = 0x3d84e1ac0dc82880, PCV2 = 0x0000000000000001 };
+	enum : uint64_t { LOW_MASK = 0x000fffffffffffff, HIGH_CONST = 0x3ff0000000000000 };
+
+	alignas(16) uint64_t state[(N + 1) * 2]; // N 128-bit words and lung
+	uint32_t idx;
+
+	uint64_t next()
+	{
+		if (idx >= N64) {
+			gen_rand_all();
+			idx = 0;
+		}
+		return state[idx++];
+	}
+	static double to_double(uint64_t u)
+	{
+		double d;
+		std::memcpy(&d, &u, sizeof d);
+		return d;
+	}
+
+	void period_certification()
+	{
+		uint64_t inner = ((state[N64] ^ FIX1) & PCV1) ^ ((state[N64 + 1] ^ FIX2) & PCV2);
+		for (int i = 32; i > 0; i >>= 1) {
+			inner ^= inner >> i;
+		}
+		if (!(inner & 1)) {
+			state[N64 + 1] ^= 1; // PCV2 & 1 == 1
+		}
+	}
+
+#if defined(SFMT_SSE2)
+	void gen_rand_all()
+	{
+		__m128i *s = reinterpret_cast<__m128i *>(state);
+		const __m128i mask = _mm_set_epi64x(MSK2, MSK1);
+		__m128i lung = _mm_load_si128(s + N);
+		auto recursion = [&](uint32_t i, uint32_t j) {
+			const __m128i x = _mm_load_si128(s + i);
+			__m128i z = _mm_slli_epi64(x, SL1);
+			__m128i y = _mm_shuffle_epi32(lung, 0x1b);
+			z = _mm_xor_si128(z, _mm_load_si128(s + j));
+			y = _mm_xor_si128(y, z);
+			__m128i v = _mm_srli_epi64(y, SR);
+			const __m128i w = _mm_and_si128(y, mask);
+			v = _mm_xor_si128(v, x);
+			v = _mm_xor_si128(v, w);
+			_mm_store_si128(s + i, v);
+			lung = y;
+		};
+		uint32_t i = 0;
+		for (; i < N - POS1; ++i) {
+			recursion(i, i + POS1);
+		}
+		for (; i < N; ++i) {
+			recursion(i, i + POS1 - N);
+		}
+		_mm_store_si128(s + N, lung);
+	}
+#else
+	void gen_rand_all()
+	{
+		uint64_t l0 = state[N64], l1 = state[N64 + 1];
+		auto recursion = [&](uint32_t i, uint32_t j) {
+			const uint64_t t0 = state[2 * i], t1 = state[2 * i + 1];
+			const uint64_t n0 = (t0 << SL1) ^ (l1 >> 32) ^ (l1 << 32) ^ state[2 * j];
+			const uint64_t n1 = (t1 << SL1) ^ (l0 >> 32) ^ (l0 << 32) ^ state[2 * j + 1];
+			l0 = n0;
+			l1 = n1;
+			state[2 * i] = (l0 >> SR) ^ (l0 & MSK1) ^ t0;
+			state[2 * i + 1] = (l1 >> SR) ^ (l1 & MSK2) ^ t1;
+		};
+		uint32_t i = 0;
+		for (; i < N - POS1; ++i) {
+			recursion(i, i + POS1);
+		}
+		for (; i < N; ++i) {
+			recursion(i, i + POS1 - N);
+		}
+		state[N64] = l0;
+		state[N64 + 1] = l1;
+	}
+#endif
+};
+
+bool operator==(const dsfmt19937_engine &lhs, const dsfmt19937_engine &rhs)
+{
+	return (lhs.idx == rhs.idx)
+		&& std::equal(std::begin(lhs.state), std::end(lhs.state), std::begin(rhs.state));
+}
+bool operator!=(const dsfmt19937_engine &lhs, const dsfmt19937_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const dsfmt19937_engine &eng)
+{
+	for (auto value : eng.state) {
+		os << value << ' ';
+	}
+	return os << eng.idx;
+}
+std::istream& operator>>(std::istream &is, dsfmt19937_engine &eng)
+{
+	for (auto &value : eng.state) {
+		is >> value;
+	}
+	return is >> eng.idx;
+}
+
+#endif // SFMT_RANDOM_H
@@ -38,9 +38,7 @@ public:
 	}
 	void discard(unsigned long long z)
 	{
-		while (z--) {
-			(*this)();
-		}
+		x += z * 0x9E3779B97F4A7C15ULL; // Weyl sequence, O(1)
 	}
 
 	friend bool operator==(const splitmix64_engine &, const splitmix64_engine &);
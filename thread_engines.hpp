@@ -0,0 +1,202 @@
+#ifndef THREAD_ENGINES_H
+#define THREAD_ENGINES_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "splitmix64_rand.hpp"
+
+// One engine per thread, each in memory of its own.
+//
+// Engines side by side in a std::vector share cache lines, so every draw
+// invalidates the lines of the neighbouring threads, and their pages were all
+// first touched by the thread that built the vector, which puts them on that
+// thread's NUMA node. Here an engine is allocated and constructed by the
+// thread that asks for it first: the memory comes from that thread's
+// allocator arena, and with the default first-touch policy its pages are
+// placed on that thread's node. Engines are padded to whole cache lines, and
+// engines of 1 KiB or more (isaac, isaac64, mt19937, cmwc) to whole pages, so
+// no two engines share a line, or for the large ones a page.
+//
+// Slot i holds Engine(seed) jumped i times for engines with a jump()
+// (xoshiro/xoroshiro), otherwise Engine seeded with output i of
+// splitmix64(seed). local() binds the calling thread to the first free slot on
+// its first call and costs a thread_local compare after that; the slot is
+// given back when the thread exits, and the next thread to bind takes over its
+// engine where it stopped, so only as many threads as there are slots may hold
+// one at a time. at(i) suits workers that know their index and want the same
+// streams on every run. A registry is used through one or the other.
+
+namespace thread_engines_detail
+{
+	template <typename Engine, typename = void>
+	struct has_jump : std::false_type {};
+	template <typename Engine>
+	struct has_jump<Engine, decltype(std::declval<Engine &>().jump())> : std::true_type {};
+
+	enum : size_t { LINE = 64, PAGE = 4096, PAGE_ENGINE = 1024 };
+
+	// registries are told apart by serial number, an address can be reused
+	inline uint64_t next_serial()
+	{
+		static std::atomic<uint64_t> serial{ 0 };
+		return ++serial;
+	}
+
+	// the owners of the slots local() handed out, shared with those owners so
+	// that a thread can give its slot back on exit after the registry is gone
+	struct slot_table
+	{
+		explicit slot_table(size_t slots) : owners(slots) {}
+
+		std::mutex lock;
+		std::vector<std::thread::id> owners;
+	};
+
+	// the slots the calling thread holds, given back when it exits
+	class held_slots
+	{
+	public:
+		~held_slots()
+		{
+			for (auto &h : held) {
+				std::lock_guard<std::mutex> guard(h.first->lock);
+				h.first->owners[h.second] = std::thread::id();
+			}
+		}
+		void add(std::shared_ptr<slot_table> table, size_t slot)
+		{
+			// tables that only this thread still refers to belong to registries that are gone
+			held.erase(std::remove_if(held.begin(), held.end(), [](const std::pair<std::shared_ptr<slot_table>, size_t> &h) {
+				return h.first.use_count() == 1;
+			}), held.end());
+			held.emplace_back(std::move(table), slot);
+		}
+
+	private:
+		std::vector<std::pair<std::shared_ptr<slot_table>, size_t>> held;
+	};
+
+	inline held_slots& this_thread_slots()
+	{
+		thread_local held_slots slots;
+		return slots;
+	}
+}
+
+template <typename Engine>
+class thread_engines
+{
+	enum : size_t {
+		ALIGN = sizeof(Engine) >= thread_engines_detail::PAGE_ENGINE ? thread_engines_detail::PAGE : thread_engines_detail::LINE,
+		SIZE = (sizeof(Engine) + ALIGN - 1) / ALIGN * ALIGN
+	};
+
+public:
+	using engine_type = Engine;
+	using result_type = typename Engine::result_type;
+
+	explicit thread_engines(size_t slots, result_type s = Engine::default_seed)
+		: engines(new std::atomic<Engine *>[slots]), table(std::make_shared<thread_engines_detail::slot_table>(slots)), count(slots), seed_value(s),
+		serial(thread_engines_detail::next_serial())
+	{
+		for (size_t i = 0; i < count; ++i) {
+			engines[i].store(nullptr, std::memory_order_relaxed);
+		}
+	}
+	thread_engines(const thread_engines &) = delete;
+	thread_engines& operator=(const thread_engines &) = delete;
+	~thread_engines()
+	{
+		for (size_t i = 0; i < count; ++i) {
+			destroy(engines[i].load(std::memory_order_relaxed));
+		}
+	}
+
+	size_t size() const { return count; }
+
+	// the engine of the calling thread
+	Engine& local()
+	{
+		struct binding
+		{
+			uint64_t serial;
+			Engine *eng;
+		};
+		thread_local binding last = { 0, nullptr };
+		if (last.serial != serial) {
+			last = { serial, &at(claim()) };
+		}
+		return *last.eng;
+	}
+	// the engine of slot i, created by the calling thread if there is none yet
+	Engine& at(size_t i)
+	{
+		Engine *eng = engines[i].load(std::memory_order_acquire);
+		return eng ? *eng : create(i);
+	}
+
+private:
+	std::unique_ptr<std::atomic<Engine *>[]> engines;
+	std::shared_ptr<thread_engines_detail::slot_table> table;
+	size_t count;
+	result_type seed_value;
+	uint64_t serial;
+
+	size_t claim()
+	{
+		std::lock_guard<std::mutex> guard(table->lock);
+		auto &owners = table->owners;
+		const auto self = std::find(owners.begin(), owners.end(), std::this_thread::get_id());
+		if (self != owners.end()) {
+			return static_cast<size_t>(self - owners.begin());
+		}
+		const auto free = std::find(owners.begin(), owners.end(), std::thread::id());
+		if (free == owners.end()) {
+			throw std::length_error("thread_engines: more threads than slots");
+		}
+		*free = std::this_thread::get_id();
+		const size_t slot = static_cast<size_t>(free - owners.begin());
+		thread_engines_detail::this_thread_slots().add(table, slot);
+		return slot;
+	}
+	Engine& create(size_t i)
+	{
+		void *p = ::operator new(SIZE, std::align_val_t(ALIGN));
+		Engine *eng;
+		if constexpr (thread_engines_detail::has_jump<Engine>::value) {
+			eng = new (p) Engine(seed_value);
+			for (size_t k = 0; k < i; ++k) {
+				eng->jump();
+			}
+		} else {
+			splitmix64_engine keys(seed_value);
+			keys.discard(i);
+			eng = new (p) Engine(static_cast<result_type>(keys()));
+		}
+		// a thread that got there first wins, its engine is already in use
+		Engine *expected = nullptr;
+		if (!engines[i].compare_exchange_strong(expected, eng, std::memory_order_acq_rel)) {
+			destroy(eng);
+			return *expected;
+		}
+		return *eng;
+	}
+	static void destroy(Engine *eng)
+	{
+		if (eng) {
+			eng->~Engine();
+			::operator delete(eng, std::align_val_t(ALIGN));
+		}
+	}
+};
+
+#endif // THREAD_ENGINES_H
@@ -0,0 +1,1190 @@
+// Differential test of the fast paths against the plain ones:
+//   rng_diff                  every check, 100 cases each
+//   rng_diff isaac -n 10000   the checks whose name contains "isaac"
+// The reference is the engine's own operator() called in a loop, or where
+// one exists an independent implementation (the C library, <random>, the
+// code a fast path replaced). A case is one check on one fuzzed input: seeds,
+// block sizes (biased towards 0, 1 and buffer boundaries), discard distances,
+// bounds.
+//
+//  <engine>/bulk      generate() in blocks, interleaved with operator()
+//  <engine>/discard   discard(z) against z calls; fast discards also as sums
+//                     of large distances
+//  <engine>/stream    operator<< then operator>>: equal, same output after
+//  <engine>/seed      the constructor against seed() on a used engine
+//  <engine>/lanes     jsf32x8 / jsf64x4 against their lane(i) engines
+//  <engine>/seed_many the static seed_many() and seed_many.hpp against seed()
+//  any/<engine>       any_engine fill() and discard() against operator(), and a
+//                     moved-from any_engine against a new one
+//  array/<engine>     engine_array advance(), discard() and indexed advance()
+//                     against one engine object per entity
+//  parallel/<engine>  parallel_generate on 1 to 4 threads in chunks of any
+//                     length against a sequential loop, or for engines with
+//                     jump() against the jumped substreams
+//  ref/...            cmwc seeding and steps, mt19937 against std::mt19937, posix
+//                     against std::linear_congruential_engine, glibc_random
+//                     against random_r and posix:: against erand48 and co.
+//                     (glibc only), atomic_splitmix64 and its reserve() against
+//                     splitmix64, thread_engines slots against their seeding,
+//                     and their release when a thread exits
+//  java/...           the array forms of java:: against the scalar calls, and
+//                     values from a JDK
+//
+// A case's input depends only on the seed (-s) and the case number, so a
+// failure is reproduced by the same command line. Exit status 1 on failure.
+//
+// g++ -std=c++17 -O2 -pthread -I.. rng_diff.cpp -o rng_diff
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../any_engine.hpp"
+#include "../atomic_splitmix64_rand.hpp"
+#include "../engine_array.hpp"
+#include "../parallel_generate.hpp"
+#include "../seed_many.hpp"
+#include "../thread_engines.hpp"
+
+namespace
+{
+	// the inputs of one case
+	class fuzz
+	{
+	public:
+		explicit fuzz(uint64_t seed) : eng(seed) {}
+
+		uint64_t operator()() { return eng(); }
+		uint64_t below(uint64_t n) { return n ? eng() % n : 0; }
+		bool coin() { return eng() & 1; }
+		// a seed, sometimes 0 or an extreme
+		uint64_t seed()
+		{
+			switch (below(8)) {
+			case 0: return 0;
+			case 1: return below(4);
+			case 2: return ~0ull - below(4);
+			default: return eng();
+			}
+		}
+		// a block length: small, near a buffer boundary of some engine, or any up to max
+		size_t size(size_t max = 5000)
+		{
+			static const size_t edges[] = { 8, 31, 32, 48, 64, 256, 312, 382, 512, 624, 1024, 4096 };
+			switch (below(4)) {
+			case 0: return below(9);
+			case 1: return std::min<size_t>(max, edges[below(std::size(edges))] + below(5) - 2);
+			default: return below(max + 1);
+			}
+		}
+
+	private:
+		splitmix64_engine eng;
+	};
+
+	// empty on success, otherwise what differed
+	using check_fn = std::function<std::string(fuzz &)>;
+
+	struct check
+	{
+		std::string name;
+		check_fn run;
+	};
+
+	std::vector<check>& checks()
+	{
+		static std::vector<check> all;
+		return all;
+	}
+	void add(const std::string &name, check_fn fn)
+	{
+		checks().push_back({ name, std::move(fn) });
+	}
+
+	template <typename... Args>
+	std::string message(Args&&... args)
+	{
+		std::ostringstream os;
+		(os << ... << args);
+		return os.str();
+	}
+
+	template <typename Engine>
+	Engine make(fuzz &f)
+	{
+		return Engine(static_cast<typename Engine::result_type>(f.seed()));
+	}
+
+	template <typename Engine, typename = void>
+	struct has_generate : std::false_type {};
+	template <typename Engine>
+	struct has_generate<Engine, decltype(std::declval<Engine &>().generate(
+		std::declval<typename Engine::result_type *>(), std::declval<typename Engine::result_type *>()))> : std::true_type {};
+
+	template <typename Engine, typename = void>
+	struct has_lanes : std::false_type {};
+	template <typename Engine>
+	struct has_lanes<Engine, decltype(void(std::declval<const Engine &>().lane(0)))> : std::true_type {};
+
+	template <typename Engine, typename = void>
+	struct has_static_seed_many : std::false_type {};
+	template <typename Engine>
+	struct has_static_seed_many<Engine, decltype(Engine::seed_many(std::declval<Engine *>(), std::declval<Engine *>(),
+		std::declval<const typename Engine::result_type *>()))> : std::true_type {};
+
+	// out[i] against the next values of ref
+	template <typename T, typename Next>
+	std::string compare(const char *what, const T *out, size_t n, uint64_t at, Next next)
+	{
+		for (size_t i = 0; i < n; ++i) {
+			const T expected = next();
+			if (!(out[i] == expected)) {
+				return message(what, " of ", n, " values from draw ", at, ": value ", i, " is ", out[i], ", expected ", expected);
+			}
+		}
+		return {};
+	}
+
+	template <typename Engine>
+	std::string check_bulk(fuzz &f)
+	{
+		using T = typename Engine::result_type;
+		Engine a = make<Engine>(f), b = a;
+		uint64_t at = 0;
+		for (unsigned round = 0; round < 8; ++round) {
+			const size_t n = f.size();
+			if (f.coin()) {
+				std::vector<T> out(n);
+				a.generate(out.data(), out.data() + n);
+				const std::string err = compare("generate", out.data(), n, at, [&b]() { return b(); });
+				if (!err.empty()) {
+					return err;
+				}
+			} else {
+				for (size_t i = 0; i < n; ++i) {
+					if (a() != b()) {
+						return message("operator() differs at draw ", at + i);
+					}
+				}
+			}
+			at += n;
+		}
+		return a == b ? std::string() : message("states differ after ", at, " draws");
+	}
+
+	template <typename Engine>
+	std::string check_discard(fuzz &f)
+	{
+		Engine a = make<Engine>(f), b = a;
+		for (unsigned round = 0; round < 4; ++round) {
+			const unsigned long long z = f.coin() ? f.size() : f.below(20000);
+			a.discard(z);
+			for (unsigned long long i = 0; i < z; ++i) {
+				b();
+			}
+			if (a != b || a() != b()) {
+				return message("discard(", z, ") differs from as many draws");
+			}
+		}
+		if constexpr (has_fast_discard<Engine>::value) {
+			const unsigned long long x = f() >> f.below(64), y = f() >> f.below(64);
+			Engine c = a;
+			a.discard(x);
+			a.discard(y);
+			c.discard(x + y);
+			if (a != c) {
+				return message("discard(", x, ") discard(", y, ") differs from discard(", x + y, ")");
+			}
+		}
+		return {};
+	}
+
+	template <typename Engine>
+	std::string check_stream(fuzz &f)
+	{
+		Engine a = make<Engine>(f);
+		for (uint64_t i = f.below(5000); i; --i) {
+			a();
+		}
+		std::stringstream ss;
+		ss << a;
+		Engine b;
+		ss >> b;
+		if (ss.fail()) {
+			return "operator>> failed on the output of operator<<";
+		}
+		if (a != b) {
+			return "the engine read back differs";
+		}
+		for (unsigned i = 0; i < 1000; ++i) {
+			if (a() != b()) {
+				return message("the engine read back differs at draw ", i);
+			}
+		}
+		return {};
+	}
+
+	template <typename Engine>
+	std::string check_seed(fuzz &f)
+	{
+		const auto s = static_cast<typename Engine::result_type>(f.seed());
+		Engine a(s), b = make<Engine>(f);
+		for (uint64_t i = f.below(2000); i; --i) {
+			b();
+		}
+		b.seed(s);
+		return a == b && a() == b() ? std::string() : message("seed(", s, ") on a used engine differs from the constructor");
+	}
+
+	template <typename Engine>
+	std::string check_lanes(fuzz &f)
+	{
+		using T = typename Engine::result_type;
+		using Lane = decltype(std::declval<const Engine &>().lane(0));
+		const auto s = static_cast<T>(f.seed());
+		Engine a(s);
+		std::vector<Lane> lanes;
+		for (size_t i = 0; i < Engine::LANES; ++i) {
+			lanes.push_back(a.lane(i));
+			// lane i is seeded like the scalar engine with s + i
+			if (lanes[i] != Lane(static_cast<T>(s + i))) {
+				return message("lane ", i, " differs from the scalar engine seeded with ", s, " + ", i);
+			}
+		}
+		const size_t steps = f.size(1000);
+		std::vector<T> out(steps * Engine::LANES);
+		a.generate(out.data(), out.data() + out.size());
+		for (size_t n = 0; n < out.size(); ++n) {
+			if (out[n] != lanes[n % Engine::LANES]()) {
+				return message("output ", n, " differs from lane ", n % Engine::LANES);
+			}
+		}
+		for (size_t i = 0; i < Engine::LANES; ++i) {
+			if (a.lane(i) != lanes[i]) {
+				return message("lane(", i, ") after ", steps, " steps differs from the scalar engine");
+			}
+		}
+		return {};
+	}
+
+	template <typename Engine>
+	std::string check_seed_many(fuzz &f)
+	{
+		using T = typename Engine::result_type;
+		const size_t n = f.below(20);
+		std::vector<T> keys(n);
+		for (auto &k : keys) {
+			k = static_cast<T>(f.seed());
+		}
+		std::vector<Engine> many(n), generic(n);
+		if constexpr (has_static_seed_many<Engine>::value) {
+			Engine::seed_many(many.data(), many.data() + n, keys.data());
+		} else {
+			many = generic;
+		}
+		seed_many(generic.data(), generic.data() + n, keys.data());
+		for (size_t i = 0; i < n; ++i) {
+			const Engine expected(keys[i]);
+			if (many[i] != expected || generic[i] != expected) {
+				return message("engine ", i, " of ", n, " differs from seed(", keys[i], ")");
+			}
+		}
+		return {};
+	}
+
+	template <typename Engine>
+	void add_engine(const std::string &name)
+	{
+		if constexpr (has_generate<Engine>::value) {
+			add(name + "/bulk", check_bulk<Engine>);
+		}
+		add(name + "/discard", check_discard<Engine>);
+		add(name + "/stream", check_stream<Engine>);
+		add(name + "/seed", check_seed<Engine>);
+		if constexpr (has_lanes<Engine>::value) {
+			add(name + "/lanes", check_lanes<Engine>);
+		}
+		if constexpr (has_static_seed_many<Engine>::value) {
+			add(name + "/seed_many", check_seed_many<Engine>);
+		}
+	}
+
+	// the seeding cmwc_engine had before it was vectorized
+	std::string check_cmwc_seed(fuzz &f)
+	{
+		const auto s = static_cast<uint32_t>(f.seed());
+		std::linear_congruential_engine<uint_fast32_t, 0x343FD, 0x269EC3, 0> lcg(s);
+		std::stringstream ss;
+		for (int i = 0; i < 4096; ++i) {
+			ss << static_cast<uint32_t>(lcg()) << ' ';
+		}
+		uint32_t carry;
+		do {
+			carry = static_cast<uint32_t>(lcg());
+		} while (carry >= 809430660);
+		ss << carry << ' ' << 4095;
+		cmwc_engine expected;
+		ss >> expected;
+		return cmwc_engine(s) == expected ? std::string() : message("seed(", s, ") differs from the <random> LCG fill");
+	}
+
+	// output of a and of ref, a drawn with operator() and generate() in turn
+	template <typename Engine, typename Ref>
+	std::string check_against(fuzz &f, Engine &a, Ref ref)
+	{
+		using T = typename Engine::result_type;
+		uint64_t at = 0;
+		for (unsigned round = 0; round < 6; ++round) {
+			const size_t n = f.size();
+			std::vector<T> out(n);
+			if constexpr (has_generate<Engine>::value) {
+				if (f.coin()) {
+					a.generate(out.data(), out.data() + n);
+				} else {
+					std::generate(out.begin(), out.end(), std::ref(a));
+				}
+			} else {
+				std::generate(out.begin(), out.end(), std::ref(a));
+			}
+			const std::string err = compare("output", out.data(), n, at, ref);
+			if (!err.empty()) {
+				return err;
+			}
+			at += n;
+		}
+		return {};
+	}
+
+	// 1 / a mod 2^32 - 1, 0 if there is none
+	inline uint32_t inverse_mod_b(uint32_t a)
+	{
+		int64_t r0 = 0xffffffff, r1 = a, t0 = 0, t1 = 1;
+		while (r1) {
+			const int64_t q = r0 / r1, r2 = r0 - q * r1, t2 = t0 - q * t1;
+			r0 = r1;
+			r1 = r2;
+			t0 = t1;
+			t1 = t2;
+		}
+		return r0 == 1 ? static_cast<uint32_t>(t0 < 0 ? t0 + 0xffffffff : t0) : 0;
+	}
+
+	// the step cmwc_engine had before it was a template, from tables with 0,
+	// 2^32 - 1 and 1 / A, where A q - 1 is a multiple of 2^32 - 1, and
+	// sometimes a carry that makes A q + c one
+	template <uint32_t R, uint32_t A, uint32_t CMax>
+	std::string check_cmwc_step(fuzz &f, basic_cmwc_engine<R, A, CMax> a)
+	{
+		std::vector<uint32_t> Q(R);
+		for (auto &q : Q) {
+			switch (f.below(5)) {
+			case 0: q = 0; break;
+			case 1: q = 0xffffffff; break;
+			case 2: q = inverse_mod_b(A); break;
+			default: q = static_cast<uint32_t>(f()); break;
+			}
+		}
+		uint32_t index = static_cast<uint32_t>(f.below(R)), carry = static_cast<uint32_t>(f.below(A));
+		if (f.coin()) {
+			for (unsigned tries = 0; tries < 1u << 20; ++tries) {
+				const uint32_t q = static_cast<uint32_t>(f());
+				const uint64_t c = (0xffffffff - uint64_t(A) * q % 0xffffffff) % 0xffffffff;
+				if (c < A) {
+					Q[(index + 1) % R] = q;
+					carry = static_cast<uint32_t>(c);
+					break;
+				}
+			}
+		}
+		std::stringstream ss;
+		for (auto q : Q) {
+			ss << q << ' ';
+		}
+		ss << carry << ' ' << index;
+		ss >> a;
+		return check_against(f, a, [&]() {
+			index = (index + 1) % R;
+			uint64_t t = uint64_t(A) * Q[index] + carry;
+			carry = t >> 32;
+			uint32_t x = static_cast<uint32_t>(t + carry);
+			if (x < carry) {
+				++x;
+				++carry;
+			}
+			return Q[index] = 0xfffffffe - x;
+		});
+	}
+
+	std::string check_mt19937(fuzz &f)
+	{
+		const auto s = static_cast<uint32_t>(f.seed());
+		mt19937_engine a(s);
+		std::mt19937 ref(s);
+		return check_against(f, a, [&ref]() { return static_cast<uint32_t>(ref()); });
+	}
+
+	std::string check_posix(fuzz &f)
+	{
+		const uint64_t s = f() >> 16;
+		posix_engine a(s);
+		posix_lcg_engine ref((s << 16 | 0x330E) & ((1ull << 48) - 1));
+		return check_against(f, a, [&ref]() { return static_cast<uint64_t>(ref()); });
+	}
+
+#if defined(__GLIBC__)
+	std::string check_glibc_random(fuzz &f)
+	{
+		const auto s = static_cast<uint32_t>(f.seed());
+		glibc_random_engine a(s);
+		char state[128]; // TYPE_3
+		random_data data = {};
+		initstate_r(s, state, sizeof state, &data);
+		return check_against(f, a, [&data]() {
+			int32_t r;
+			random_r(&data, &r);
+			return static_cast<uint32_t>(r);
+		});
+	}
+
+	std::string check_drand48(fuzz &f)
+	{
+		const uint64_t s = static_cast<uint32_t>(f());
+		posix_engine eng(s);
+		// the state srand48(s) sets, low 16 bits first
+		unsigned short ref[3] = { 0x330E, static_cast<unsigned short>(s), static_cast<unsigned short>(s >> 16) };
+		unsigned short xsubi[3] = { static_cast<unsigned short>(f()), static_cast<unsigned short>(f()), static_cast<unsigned short>(f()) };
+		unsigned short xref[3] = { xsubi[0], xsubi[1], xsubi[2] };
+		uint64_t at = 0;
+		for (unsigned round = 0; round < 6; ++round) {
+			const size_t n = f.size();
+			std::vector<double> d(n);
+			std::vector<long> l(n);
+			std::string err;
+			switch (f.below(6)) {
+			case 0:
+				posix::drand48(eng, d.data(), d.data() + n);
+				err = compare("posix::drand48", d.data(), n, at, [&ref]() { return erand48(ref); });
+				break;
+			case 1:
+				posix::lrand48(eng, l.data(), l.data() + n);
+				err = compare("posix::lrand48", l.data(), n, at, [&ref]() { return nrand48(ref); });
+				break;
+			case 2:
+				posix::mrand48(eng, l.data(), l.data() + n);
+				err = compare("posix::mrand48", l.data(), n, at, [&ref]() { return jrand48(ref); });
+				break;
+			case 3:
+				posix::erand48(xsubi, d.data(), d.data() + n);
+				err = compare("posix::erand48", d.data(), n, at, [&xref]() { return erand48(xref); });
+				break;
+			case 4:
+				posix::nrand48(xsubi, l.data(), l.data() + n);
+				err = compare("posix::nrand48", l.data(), n, at, [&xref]() { return nrand48(xref); });
+				break;
+			default:
+				for (size_t i = 0; i < n; ++i) {
+					l[i] = posix::jrand48(xsubi);
+				}
+				err = compare("posix::jrand48", l.data(), n, at, [&xref]() { return jrand48(xref); });
+				break;
+			}
+			if (!err.empty()) {
+				return err;
+			}
+			at += n;
+		}
+		return {};
+	}
+#endif
+
+	int32_t fuzz_bound(fuzz &f)
+	{
+		switch (f.below(4)) {
+		case 0: return int32_t(1) << f.below(31);
+		case 1: return static_cast<int32_t>(1 + f.below(100));
+		case 2: return std::numeric_limits<int32_t>::max() - static_cast<int32_t>(f.below(4));
+		default: return static_cast<int32_t>(1 + f.below(std::numeric_limits<int32_t>::max()));
+		}
+	}
+
+	// the array forms of java:: and java::random against the scalar calls
+	template <typename Engine>
+	std::string check_java_forms(fuzz &f, Engine &a, Engine &b)
+	{
+		for (unsigned round = 0; round < 6; ++round) {
+			const size_t n = f.size(2000);
+			const int32_t bound = fuzz_bound(f);
+			std::vector<int32_t> i32(n);
+			std::vector<int64_t> i64(n);
+			std::vector<double> d(n);
+			std::string err;
+			switch (f.below(4)) {
+			case 0:
+				java::next_int(a, i32.data(), i32.data() + n);
+				err = compare("next_int", i32.data(), n, 0, [&b]() { return java::next_int(b); });
+				break;
+			case 1:
+				java::next_int(a, bound, i32.data(), i32.data() + n);
+				err = compare("next_int(bound)", i32.data(), n, 0, [&b, bound]() { return java::next_int(b, bound); });
+				break;
+			case 2:
+				java::next_long(a, i64.data(), i64.data() + n);
+				err = compare("next_long", i64.data(), n, 0, [&b]() { return java::next_long(b); });
+				break;
+			default:
+				java::next_double(a, d.data(), d.data() + n);
+				err = compare("next_double", d.data(), n, 0, [&b]() { return java::next_double(b); });
+				break;
+			}
+			if (!err.empty()) {
+				return err;
+			}
+			if (a != b) {
+				return "the array form leaves the engine elsewhere";
+			}
+		}
+		return {};
+	}
+
+	std::string check_java(fuzz &f)
+	{
+		java_engine a(f.seed()), b = a;
+		return check_java_forms(f, a, b);
+	}
+
+	std::string check_java_splittable(fuzz &f)
+	{
+		java_splittable_engine a(f.seed());
+		for (uint64_t i = f.below(4); i; --i) {
+			a = a.split();
+		}
+		java_splittable_engine b = a;
+		return check_java_forms(f, a, b);
+	}
+
+	std::string check_java_gaussian(fuzz &f)
+	{
+		const auto s = static_cast<int64_t>(f.seed());
+		java::random a(s), b(s);
+		for (unsigned round = 0; round < 6; ++round) {
+			const size_t n = f.size(2000);
+			std::vector<double> d(n);
+			a.next_gaussian(d.data(), d.data() + n);
+			const std::string err = compare("next_gaussian", d.data(), n, 0, [&b]() { return b.next_gaussian(); });
+			if (!err.empty()) {
+				return err;
+			}
+			if (a.engine() != b.engine() || a.next_gaussian() != b.next_gaussian()) {
+				return "next_gaussian's array form leaves the object elsewhere";
+			}
+		}
+		return {};
+	}
+
+	std::string check_any(fuzz &f, const std::string &name)
+	{
+		any_engine a(name, f.seed()), b = a;
+		uint64_t at = 0;
+		for (unsigned round = 0; round < 6; ++round) {
+			const size_t n = f.size();
+			std::vector<uint64_t> out(n);
+			std::string err;
+			switch (f.below(4)) {
+			case 0:
+				a.fill(out.data(), out.data() + n);
+				err = compare("fill", out.data(), n, at, [&b]() { return b(); });
+				break;
+			case 1:
+				a.discard(n);
+				for (size_t i = 0; i < n; ++i) {
+					b();
+				}
+				err = a == b ? std::string() : message("discard(", n, ") differs from as many draws");
+				break;
+			case 2:
+				{
+					any_engine c(std::move(a));
+					if (!(a == any_engine(name)) || a() != any_engine(name)()) {
+						err = "a moved-from any_engine is not a new one";
+						break;
+					}
+					c.fill(out.data(), out.data() + n);
+					err = compare("fill after a move", out.data(), n, at, [&b]() { return b(); });
+					a = std::move(c);
+				}
+				break;
+			default:
+				{
+					std::stringstream ss;
+					ss << a;
+					any_engine c;
+					ss >> c;
+					err = !ss.fail() && c == a ? std::string() : "operator>> does not restore operator<<";
+					a = c;
+				}
+				break;
+			}
+			if (!err.empty()) {
+				return err;
+			}
+			at += n;
+		}
+		return a == b ? std::string() : "states differ at the end";
+	}
+
+	// engine_array against one engine object per entity
+	template <typename Engine>
+	std::string check_engine_array(fuzz &f)
+	{
+		using T = typename Engine::result_type;
+		const size_t n = f.below(40);
+		std::vector<T> seeds(n);
+		std::vector<Engine> ref;
+		for (auto &s : seeds) {
+			s = static_cast<T>(f.seed());
+			ref.emplace_back(s);
+		}
+		engine_array<Engine> a;
+		if (f.coin()) {
+			a = engine_array<Engine>(seeds.begin(), seeds.end());
+		} else {
+			a = engine_array<Engine>(n);
+			for (size_t i = 0; i < n; ++i) {
+				a.set(i, ref[i]);
+			}
+		}
+		for (unsigned round = 0; round < 6; ++round) {
+			std::vector<T> out;
+			switch (f.below(3)) {
+			case 0:
+				out.resize(n);
+				a.advance(out.data());
+				for (size_t i = 0; i < n; ++i) {
+					if (out[i] != ref[i]()) {
+						return message("advance(): entity ", i, " of ", n, " differs from its engine");
+					}
+				}
+				break;
+			case 1:
+				{
+					const unsigned long long z = f.below(100);
+					a.discard(z);
+					for (auto &e : ref) {
+						e.discard(z);
+					}
+				}
+				break;
+			default:
+				{
+					// indices may repeat, each occurrence is one step
+					std::vector<size_t> index(n ? f.size(200) : 0);
+					for (auto &i : index) {
+						i = f.below(n);
+					}
+					out.resize(index.size());
+					a.advance(index.begin(), index.end(), out.data());
+					for (size_t k = 0; k < index.size(); ++k) {
+						if (out[k] != ref[index[k]]()) {
+							return message("advance() of ", index.size(), " indices: output ", k, " (entity ", index[k], ") differs from its engine");
+						}
+					}
+				}
+				break;
+			}
+			for (size_t i = 0; i < n; ++i) {
+				if (a.get(i) != ref[i]) {
+					return message("entity ", i, " of ", n, " differs from its engine in round ", round);
+				}
+			}
+		}
+		return {};
+	}
+
+	// parallel_generate against a sequential loop, or for engines with jump()
+	// against the first chunk values of each jumped substream
+	template <typename Engine>
+	std::string check_parallel(fuzz &f)
+	{
+		using T = typename Engine::result_type;
+		Engine a = make<Engine>(f), b = a;
+		for (unsigned round = 0; round < 4; ++round) {
+			const size_t n = f.size(20000);
+			const size_t chunk = f.coin() ? 1 + f.below(64) : 1 + f.size(n);
+			const unsigned threads = 1 + static_cast<unsigned>(f.below(4));
+			std::vector<T> out(n);
+			parallel_generate(a, out.begin(), out.end(), threads, chunk);
+			std::string err;
+			if constexpr (has_fast_discard<Engine>::value) {
+				err = compare("parallel_generate", out.data(), n, 0, [&b]() { return b(); });
+			} else {
+				Engine sub = b;
+				size_t left = 0;
+				err = compare("parallel_generate", out.data(), n, 0, [&]() {
+					if (left == 0) {
+						sub = b;
+						b.jump();
+						left = chunk;
+					}
+					--left;
+					return sub();
+				});
+			}
+			if (!err.empty()) {
+				return message(err, " (", threads, " threads, chunks of ", chunk, ")");
+			}
+			if (a != b) {
+				return message("parallel_generate of ", n, " values in chunks of ", chunk, " leaves the engine elsewhere");
+			}
+		}
+		std::vector<T> out(f.size());
+		try {
+			parallel_generate(a, out.begin(), out.end(), 1, 0);
+			return "parallel_generate accepts chunks of 0";
+		} catch (const std::invalid_argument &) {
+		}
+		return a == b ? std::string() : "a rejected parallel_generate moves the engine";
+	}
+
+	// atomic_splitmix64_engine and its reserve() against splitmix64_engine, then
+	// blocks reserved by several threads against the values they share out
+	std::string check_atomic_splitmix64(fuzz &f)
+	{
+		const uint64_t s = f.seed();
+		atomic_splitmix64_engine a(s);
+		splitmix64_engine b(s);
+		uint64_t at = 0;
+		for (unsigned round = 0; round < 6; ++round) {
+			const size_t n = f.size();
+			std::vector<uint64_t> out(n);
+			std::string err;
+			switch (f.below(3)) {
+			case 0:
+				std::generate(out.begin(), out.end(), std::ref(a));
+				err = compare("operator()", out.data(), n, at, [&b]() { return b(); });
+				break;
+			case 1:
+				{
+					splitmix64_engine r = a.reserve(n);
+					std::generate(out.begin(), out.end(), std::ref(r));
+					err = compare("reserve()", out.data(), n, at, [&b]() { return b(); });
+				}
+				break;
+			default:
+				a.discard(n);
+				b.discard(n);
+				break;
+			}
+			if (!err.empty()) {
+				return err;
+			}
+			at += n;
+		}
+		const unsigned threads = 2 + static_cast<unsigned>(f.below(3));
+		const size_t k = 1 + f.below(64), blocks = 1 + f.below(64);
+		std::vector<std::vector<uint64_t>> drawn(threads);
+		std::vector<std::thread> pool;
+		for (unsigned t = 0; t < threads; ++t) {
+			pool.emplace_back([&, t]() {
+				for (size_t j = 0; j < blocks; ++j) {
+					splitmix64_engine r = a.reserve(k);
+					for (size_t i = 0; i < k; ++i) {
+						drawn[t].push_back(r());
+					}
+				}
+			});
+		}
+		for (auto &t : pool) {
+			t.join();
+		}
+		std::vector<uint64_t> all, expected(threads * blocks * k);
+		for (auto &d : drawn) {
+			all.insert(all.end(), d.begin(), d.end());
+		}
+		std::generate(expected.begin(), expected.end(), std::ref(b));
+		std::sort(all.begin(), all.end());
+		std::sort(expected.begin(), expected.end());
+		if (all != expected) {
+			return message(threads, " threads reserving ", blocks, " blocks of ", k, " drew other values than one engine");
+		}
+		return a() == b() ? std::string() : "the engine is elsewhere after the threads' blocks";
+	}
+
+	// thread_engines slots against Engine(seed) jumped i times or seeded with
+	// output i of splitmix64(seed), and local() against the slots
+	template <typename Engine>
+	std::string check_thread_engines(fuzz &f)
+	{
+		using T = typename Engine::result_type;
+		const auto s = static_cast<T>(f.seed());
+		const size_t n = 1 + f.below(8);
+		std::vector<Engine> expected;
+		Engine jumped(s);
+		splitmix64_engine keys(s);
+		for (size_t i = 0; i < n; ++i) {
+			if constexpr (thread_engines_detail::has_jump<Engine>::value) {
+				expected.push_back(jumped);
+				jumped.jump();
+			} else {
+				expected.emplace_back(static_cast<T>(keys()));
+			}
+		}
+		const uintptr_t align = sizeof(Engine) >= thread_engines_detail::PAGE_ENGINE ? thread_engines_detail::PAGE : thread_engines_detail::LINE;
+
+		// slots created in any order, by this thread or another one
+		thread_engines<Engine> by_index(n, s);
+		std::vector<size_t> order(n);
+		for (size_t i = 0; i < n; ++i) {
+			order[i] = i;
+		}
+		for (size_t i = n; i > 1; --i) {
+			std::swap(order[i - 1], order[f.below(i)]);
+		}
+		for (size_t i : order) {
+			Engine *eng = nullptr;
+			if (f.coin()) {
+				std::thread([&]() { eng = &by_index.at(i); }).join();
+			} else {
+				eng = &by_index.at(i);
+			}
+			if (*eng != expected[i]) {
+				return message("slot ", i, " of ", n, " differs from its seeding");
+			}
+			if (reinterpret_cast<uintptr_t>(eng) % align) {
+				return message("slot ", i, " is not aligned to ", align, " bytes");
+			}
+			if (&by_index.at(i) != eng) {
+				return message("slot ", i, " moved");
+			}
+		}
+
+		// every thread gets a slot of its own and keeps it; the threads are all
+		// alive until each has its slot
+		thread_engines<Engine> by_thread(n, s);
+		const size_t threads = 1 + f.below(n);
+		std::vector<Engine *> local(threads);
+		std::vector<char> same(threads);
+		std::atomic<size_t> bound{ 0 };
+		std::vector<std::thread> pool;
+		for (size_t t = 0; t < threads; ++t) {
+			pool.emplace_back([&, t]() {
+				local[t] = &by_thread.local();
+				++bound;
+				while (bound < threads) {
+					std::this_thread::yield();
+				}
+				same[t] = &by_thread.local() == local[t];
+			});
+		}
+		for (auto &t : pool) {
+			t.join();
+		}
+		for (size_t t = 0; t < threads; ++t) {
+			if (!same[t]) {
+				return message("local() changed within thread ", t);
+			}
+			const auto slot = std::find_if(order.begin(), order.end(), [&](size_t i) { return &by_thread.at(i) == local[t]; });
+			if (slot == order.end()) {
+				return message("local() of thread ", t, " is no slot");
+			}
+			if (*local[t] != expected[*slot]) {
+				return message("local() of thread ", t, " differs from the seeding of slot ", *slot);
+			}
+			if (std::count(local.begin(), local.end(), local[t]) != 1) {
+				return message("threads share slot ", *slot);
+			}
+		}
+
+		// the slots come back as their threads exit, so threads one after the
+		// other find one however many there are
+		for (size_t t = 0; t < 2 * n; ++t) {
+			bool bound_one = true;
+			std::thread([&]() {
+				try {
+					by_thread.local();
+				} catch (const std::length_error &) {
+					bound_one = false;
+				}
+			}).join();
+			if (!bound_one) {
+				return message("thread ", t, " after ", threads + t, " exited threads found none of the ", n, " slots free");
+			}
+		}
+		return {};
+	}
+
+	// new Random(seed).nextInt(), .nextDouble() and the first nextGaussian()
+	// values, as printed by a JDK
+	std::string check_java_jdk(fuzz &)
+	{
+		const struct
+		{
+			int64_t seed;
+			int32_t next_int;
+			double next_double;
+		} scalar[] = {
+			{ 0, -1155484576, 0.730967787376657 },
+			{ 1, -1155869325, 0.7308781907032909 },
+			{ 42, -1170105035, 0.7275636800328681 },
+		};
+		for (auto &v : scalar) {
+			java::random a(v.seed), b(v.seed);
+			if (a.next_int() != v.next_int) {
+				return message("new Random(", v.seed, ").nextInt() is not ", v.next_int);
+			}
+			if (b.next_double() != v.next_double) {
+				return message("new Random(", v.seed, ").nextDouble() is not ", v.next_double);
+			}
+		}
+		const struct
+		{
+			int64_t seed;
+			double values[4];
+		} gaussian[] = {
+			{ 0, { 0.8025330637390305, -0.9015460884175122, 2.080920790428163, 0.7637707684364894 } },
+			{ 42, { 1.1419053154730547, 0.9194079489827879, -0.9498666368908959, -1.1069902863993377 } },
+		};
+		for (auto &v : gaussian) {
+			java::random a(v.seed), b(v.seed);
+			double d[4];
+			b.next_gaussian(d, d + 4);
+			for (size_t i = 0; i < 4; ++i) {
+				if (a.next_gaussian() != v.values[i] || d[i] != v.values[i]) {
+					return message("nextGaussian() ", i, " of new Random(", v.seed, ") is not ", v.values[i]);
+				}
+			}
+		}
+		return {};
+	}
+
+	void register_checks()
+	{
+		add_engine<bsd_engine>("bsd");
+		add_engine<cmwc_engine>("cmwc");
+		add_engine<cmwc8_engine>("cmwc8");
+		add_engine<cmwc256_engine>("cmwc256");
+		add_engine<dsfmt19937_engine>("dsfmt19937");
+		add_engine<glibc_engine>("glibc");
+		add_engine<glibc_random_engine>("glibc_random");
+		add_engine<isaac_engine>("isaac");
+		add_engine<isaac64_engine>("isaac64");
+		add_engine<java_engine>("java");
+		add_engine<java_splittable_engine>("java_splittable");
+		add_engine<jsf32_engine>("jsf32");
+		add_engine<jsf32x8_engine>("jsf32x8");
+		add_engine<jsf64_engine>("jsf64");
+		add_engine<jsf64x4_engine>("jsf64x4");
+		add_engine<mmix_engine>("mmix");
+		add_engine<msvc_engine>("msvc");
+		add_engine<mt19937_engine>("mt19937");
+		add_engine<posix_engine>("posix");
+		add_engine<romu_duo_jr_engine>("romuduojr");
+		add_engine<romu_trio_engine>("romutrio");
+		add_engine<sfc64_engine>("sfc64");
+		add_engine<sfmt19937_engine>("sfmt19937");
+		add_engine<splitmix64_engine>("splitmix64");
+		add_engine<wyrand_engine>("wyrand");
+		add_engine<xoroshiro64_engine>("xoroshiro64**");
+		add_engine<xoroshiro128plus_engine>("xoroshiro128+");
+		add_engine<xoroshiro128plusplus_engine>("xoroshiro128++");
+		add_engine<xoroshiro128_engine>("xoroshiro128**");
+		add_engine<xoshiro128_engine>("xoshiro128**");
+		add_engine<xoshiro256plus_engine>("xoshiro256+");
+		add_engine<xoshiro256plusplus_engine>("xoshiro256++");
+		add_engine<xoshiro256_engine>("xoshiro256**");
+		add("dsfmt19937/bulk_double", [](fuzz &f) {
+			dsfmt19937_engine a = make<dsfmt19937_engine>(f), b = a;
+			const size_t n = f.size();
+			std::vector<double> out(n);
+			a.generate(out.data(), out.data() + n);
+			return compare("generate", out.data(), n, 0, [&b]() { return b.next_double(); });
+		});
+
+		add("ref/cmwc_seed", check_cmwc_seed);
+		add("ref/cmwc_step", [](fuzz &f) { return check_cmwc_step(f, cmwc_engine()); });
+		add("ref/cmwc8_step", [](fuzz &f) { return check_cmwc_step(f, cmwc8_engine()); });
+		add("ref/cmwc256_step", [](fuzz &f) { return check_cmwc_step(f, cmwc256_engine()); });
+		add("ref/mt19937", check_mt19937);
+		add("ref/posix", check_posix);
+#if defined(__GLIBC__)
+		add("ref/glibc_random", check_glibc_random);
+		add("ref/drand48", check_drand48);
+#endif
+		add("java/random", check_java);
+		add("java/splittable", check_java_splittable);
+		add("java/gaussian", check_java_gaussian);
+		add("java/jdk", check_java_jdk);
+
+		add("array/jsf32", check_engine_array<jsf32_engine>);
+		add("array/jsf64", check_engine_array<jsf64_engine>);
+		add("array/splitmix64", check_engine_array<splitmix64_engine>);
+		add("array/xoroshiro64**", check_engine_array<xoroshiro64_engine>);
+		add("array/xoroshiro128+", check_engine_array<xoroshiro128plus_engine>);
+		add("array/xoroshiro128++", check_engine_array<xoroshiro128plusplus_engine>);
+		add("array/xoroshiro128**", check_engine_array<xoroshiro128_engine>);
+		add("array/xoshiro128**", check_engine_array<xoshiro128_engine>);
+		add("array/xoshiro256+", check_engine_array<xoshiro256plus_engine>);
+		add("array/xoshiro256++", check_engine_array<xoshiro256plusplus_engine>);
+		add("array/xoshiro256**", check_engine_array<xoshiro256_engine>);
+
+		add("parallel/glibc", check_parallel<glibc_engine>);
+		add("parallel/java", check_parallel<java_engine>);
+		add("parallel/java_splittable", check_parallel<java_splittable_engine>);
+		add("parallel/mmix", check_parallel<mmix_engine>);
+		add("parallel/msvc", check_parallel<msvc_engine>);
+		add("parallel/posix", check_parallel<posix_engine>);
+		add("parallel/splitmix64", check_parallel<splitmix64_engine>);
+		add("parallel/xoroshiro128**", check_parallel<xoroshiro128_engine>);
+		add("parallel/xoshiro128**", check_parallel<xoshiro128_engine>);
+		add("parallel/xoshiro256**", check_parallel<xoshiro256_engine>);
+
+		add("ref/atomic_splitmix64", check_atomic_splitmix64);
+		add("ref/thread_engines_xoshiro256**", check_thread_engines<xoshiro256_engine>);
+		add("ref/thread_engines_sfc64", check_thread_engines<sfc64_engine>);
+		add("ref/thread_engines_isaac64", check_thread_engines<isaac64_engine>);
+
+		for (auto &name : any_engine::names()) {
+			add("any/" + name, [name](fuzz &f) { return check_any(f, name); });
+		}
+	}
+
+	// FNV-1a, so that case inputs do not depend on the standard library
+	uint64_t hash(const std::string &s)
+	{
+		uint64_t h = 0xCBF29CE484222325;
+		for (unsigned char c : s) {
+			h = (h ^ c) * 0x100000001B3;
+		}
+		return h;
+	}
+
+	struct options
+	{
+		std::string filter;
+		uint64_t seed = 1;
+		uint64_t cases = 100;
+		uint64_t only = ~0ull; // -k: a single case
+		unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	};
+
+	int run(const options &opt)
+	{
+		std::vector<const check *> selected;
+		for (auto &c : checks()) {
+			if (c.name.find(opt.filter) != std::string::npos) {
+				selected.push_back(&c);
+			}
+		}
+		if (selected.empty()) {
+			std::fprintf(stderr, "rng_diff: no check matches '%s'\n", opt.filter.c_str());
+			return 2;
+		}
+		const uint64_t first = opt.only == ~0ull ? 0 : opt.only;
+		const uint64_t per_check = opt.only == ~0ull ? opt.cases : 1;
+		const uint64_t total = selected.size() * per_check;
+
+		std::atomic<uint64_t> next{ 0 };
+		std::atomic<uint64_t> failures{ 0 };
+		std::mutex report;
+		const auto start = std::chrono::steady_clock::now();
+		auto worker = [&]() {
+			for (uint64_t job; (job = next.fetch_add(1, std::memory_order_relaxed)) < total;) {
+				const check &c = *selected[job / per_check];
+				const uint64_t k = first + job % per_check;
+				fuzz f(hash(c.name) ^ (opt.seed * 0x9E3779B97F4A7C15) ^ k);
+				std::string err;
+				try {
+					err = c.run(f);
+				} catch (const std::exception &e) {
+					err = std::string("exception: ") + e.what();
+				}
+				if (!err.empty() && failures.fetch_add(1) < 20) {
+					std::lock_guard<std::mutex> lock(report);
+					std::printf("FAIL %s case %llu: %s\n", c.name.c_str(), static_cast<unsigned long long>(k), err.c_str());
+				}
+			}
+		};
+		std::vector<std::thread> pool;
+		for (unsigned t = 1; t < opt.threads; ++t) {
+			pool.emplace_back(worker);
+		}
+		worker();
+		for (auto &t : pool) {
+			t.join();
+		}
+		const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+
+		std::printf("%zu checks, %llu cases, seed %llu, %u threads, %.1f s: %llu failed\n", selected.size(),
+			static_cast<unsigned long long>(total), static_cast<unsigned long long>(opt.seed), opt.threads, dt.count(),
+			static_cast<unsigned long long>(failures.load()));
+		return failures ? 1 : 0;
+	}
+
+	bool parse_number(const char *s, uint64_t &value)
+	{
+		char *end;
+		value = std::strtoull(s, &end, 0);
+		return end != s && *end == '\0';
+	}
+
+	int usage()
+	{
+		std::fprintf(stderr,
+			"usage: rng_diff [filter] [-n cases] [-s seed] [-k case] [-t threads]\n"
+			"  filter  run the checks whose name contains it\n"
+			"  -n      cases per check, default 100\n"
+			"  -s      seed of the case inputs, default 1\n"
+			"  -k      only case k of each check, to reproduce a failure\n"
+			"  -t      threads, default: all cores\n"
+			"exit status 1 when a case fails\n"
+			"checks:");
+		for (auto &c : checks()) {
+			std::fprintf(stderr, " %s", c.name.c_str());
+		}
+		std::fprintf(stderr, "\n");
+		return 2;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	register_checks();
+	options opt;
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		uint64_t value;
+		if (arg == "-n" && i + 1 < argc && parse_number(argv[i + 1], value) && value > 0) {
+			opt.cases = value;
+			++i;
+		} else if (arg == "-s" && i + 1 < argc && parse_number(argv[i + 1], value)) {
+			opt.seed = value;
+			++i;
+		} else if (arg == "-k" && i + 1 < argc && parse_number(argv[i + 1], value)) {
+			opt.only = value;
+			++i;
+		} else if (arg == "-t" && i + 1 < argc && parse_number(argv[i + 1], value) && value > 0) {
+			opt.threads = static_cast<unsigned>(value);
+			++i;
+		} else if (i == 1 && arg[0] != '-') {
+			opt.filter = arg;
+		} else {
+			return usage();
+		}
+	}
+	return run(opt);
+}
+
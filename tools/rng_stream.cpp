@@ -0,0 +1,248 @@
+// Raw engine output on stdout, for PractRand / TestU01 / dieharder:
+//   rng_stream 'xoshiro256**' 42 | RNG_test stdin64
+//   rng_stream sfmt19937 1 -n 1T -H | RNG_test stdin32
+// Output is the native-endian 64-bit words of any_engine::fill: the results of
+// 64-bit engines, pairs of results of 32-bit engines, and results of engines
+// with fewer significant bits (glibc, msvc, posix, dSFMT...) packed into full
+// words with rand_util::word64.
+//
+// The output is generated in bulk into two large page-aligned buffers that are
+// handed to the pipe with vmsplice while the other one is refilled, or written
+// with write() when stdout is not a pipe. Throughput goes to stderr.
+//
+// g++ -std=c++17 -O3 -march=native -I.. rng_stream.cpp -o rng_stream
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include "../any_engine.hpp"
+
+namespace
+{
+	struct options
+	{
+		uint64_t seed = 1;
+		uint64_t bytes = 0; // 0: until the reader goes away
+		size_t buffer = 8 << 20;
+		bool hugepages = false;
+		bool quiet = false;
+	};
+
+	unsigned char* allocate(size_t size, bool hugepages)
+	{
+#if defined(__linux__)
+		void *p = MAP_FAILED;
+		if (hugepages) {
+			p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (p == MAP_FAILED) {
+				std::fprintf(stderr, "rng_stream: no hugetlb pages, falling back to transparent huge pages\n");
+			}
+		}
+		if (p == MAP_FAILED) {
+			p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (p == MAP_FAILED) {
+				throw std::bad_alloc();
+			}
+			if (hugepages) {
+				madvise(p, size, MADV_HUGEPAGE);
+			}
+		}
+		return static_cast<unsigned char *>(p);
+#else
+		(void)hugepages;
+		return static_cast<unsigned char *>(::operator new(size, std::align_val_t(4096)));
+#endif
+	}
+
+	class output
+	{
+	public:
+		explicit output(size_t buffer)
+		{
+#if defined(__linux__)
+			struct stat st;
+			if (fstat(STDOUT_FILENO, &st) == 0 && S_ISFIFO(st.st_mode)) {
+				// a buffer may be rewritten once the pipe holds none of its pages,
+				// which is guaranteed when the pipe is not larger than a buffer
+				fcntl(STDOUT_FILENO, F_SETPIPE_SZ, static_cast<int>(std::min<size_t>(buffer, 1 << 30)));
+				const int capacity = fcntl(STDOUT_FILENO, F_GETPIPE_SZ);
+				splice = capacity > 0 && static_cast<size_t>(capacity) <= buffer;
+			}
+#elif defined(_WIN32)
+			_setmode(_fileno(stdout), _O_BINARY);
+#endif
+			(void)buffer;
+		}
+		bool uses_vmsplice() const { return splice; }
+
+		// false when the reader has gone away
+		bool put(const unsigned char *p, size_t size)
+		{
+			while (size) {
+				long n;
+#if defined(__linux__)
+				if (splice) {
+					iovec iov = { const_cast<unsigned char *>(p), size };
+					n = vmsplice(STDOUT_FILENO, &iov, 1, 0);
+				} else {
+					n = write(STDOUT_FILENO, p, size);
+				}
+#elif defined(_WIN32)
+				n = _write(1, p, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+#else
+				n = write(STDOUT_FILENO, p, size);
+#endif
+				if (n < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					if (errno != EPIPE) {
+						std::perror("rng_stream");
+					}
+					return false;
+				}
+				p += n;
+				size -= static_cast<size_t>(n);
+			}
+			return true;
+		}
+
+	private:
+		bool splice = false;
+	};
+
+	int stream(any_engine &eng, const options &opt)
+	{
+		unsigned char *buf[2] = { allocate(opt.buffer, opt.hugepages), allocate(opt.buffer, opt.hugepages) };
+		output out(opt.buffer);
+		if (!opt.quiet) {
+			std::fprintf(stderr, "rng_stream: %zu MiB buffers, %s\n", opt.buffer >> 20,
+				out.uses_vmsplice() ? "vmsplice" : "write");
+		}
+
+		using clock = std::chrono::steady_clock;
+		const auto start = clock::now();
+		auto last_report = start;
+		uint64_t total = 0;
+		for (unsigned k = 0; opt.bytes == 0 || total < opt.bytes; k ^= 1) {
+			const size_t size = static_cast<size_t>(opt.bytes ? std::min<uint64_t>(opt.buffer, opt.bytes - total) : opt.buffer);
+			eng.fill(reinterpret_cast<uint64_t *>(buf[k]), reinterpret_cast<uint64_t *>(buf[k]) + (size + 7) / 8);
+			if (!out.put(buf[k], size)) {
+				break;
+			}
+			total += size;
+
+			const auto now = clock::now();
+			if (!opt.quiet && now - last_report >= std::chrono::seconds(10)) {
+				const std::chrono::duration<double> dt = now - start;
+				std::fprintf(stderr, "rng_stream: %.1f GiB, %.0f MB/s\n", total / 1073741824.0, total / dt.count() / 1e6);
+				last_report = now;
+			}
+		}
+		const std::chrono::duration<double> dt = clock::now() - start;
+		if (!opt.quiet) {
+			std::fprintf(stderr, "rng_stream: %.3f GiB in %.2f s, %.0f MB/s\n", total / 1073741824.0, dt.count(),
+				total / dt.count() / 1e6);
+		}
+		return 0;
+	}
+
+	// 123, 64K, 16M, 1G, 2T
+	bool parse_size(const char *s, uint64_t &value)
+	{
+		char *end;
+		value = std::strtoull(s, &end, 0);
+		if (end == s) {
+			return false;
+		}
+		switch (*end) {
+		case 'T': case 't': value <<= 10; [[fallthrough]];
+		case 'G': case 'g': value <<= 10; [[fallthrough]];
+		case 'M': case 'm': value <<= 10; [[fallthrough]];
+		case 'K': case 'k': value <<= 10; ++end; break;
+		default: break;
+		}
+		return *end == '\0';
+	}
+
+	int usage()
+	{
+		std::fprintf(stderr,
+			"usage: rng_stream <engine> [seed] [-n bytes] [-b buffer] [-H] [-q]\n"
+			"  -n  stop after this many bytes (suffix K, M, G, T), default: until the reader exits\n"
+			"  -b  size of each of the two buffers, default 8M\n"
+			"  -H  back the buffers with huge pages\n"
+			"  -q  no throughput report\n"
+			"engines:");
+		for (auto &name : any_engine::names()) {
+			std::fprintf(stderr, " %s", name.c_str());
+		}
+		std::fprintf(stderr, "\n");
+		return 2;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		return usage();
+	}
+	options opt;
+	for (int i = 2; i < argc; ++i) {
+		const std::string arg = argv[i];
+		uint64_t size;
+		if ((arg == "-n" || arg == "-b") && i + 1 < argc && parse_size(argv[i + 1], size)) {
+			if (arg == "-n") {
+				opt.bytes = size;
+			} else {
+				// whole pages, whole 64-bit words
+				opt.buffer = static_cast<size_t>(std::max<uint64_t>((size + 4095) & ~uint64_t(4095), 4096));
+			}
+			++i;
+		} else if (arg == "-H") {
+			opt.hugepages = true;
+		} else if (arg == "-q") {
+			opt.quiet = true;
+		} else if (i == 2 && parse_size(argv[i], size)) {
+			opt.seed = size;
+		} else {
+			return usage();
+		}
+	}
+	if (opt.hugepages) {
+		opt.buffer = (opt.buffer + (2 << 20) - 1) & ~size_t((2 << 20) - 1);
+	}
+
+#if defined(SIGPIPE)
+	std::signal(SIGPIPE, SIG_IGN);
+#endif
+	any_engine eng;
+	try {
+		eng = any_engine(argv[1], opt.seed);
+	} catch (const std::invalid_argument &) {
+		std::fprintf(stderr, "rng_stream: unknown engine '%s'\n", argv[1]);
+		return usage();
+	}
+	return stream(eng, opt);
+}
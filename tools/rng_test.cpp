@@ -0,0 +1,488 @@
+// Quick statistical smoke test of an engine, minutes instead of a BigCrush:
+//   rng_test mmix 1 -n 64G
+// Every thread tests its own stream, seeded with output t of splitmix64(seed)
+// for thread t (engines such as jsf32x8 seed their lanes with seed + i, so
+// consecutive seeds would share lanes), in blocks of 64-bit words from
+// any_engine::fill. The counts of all threads are pooled and each test
+// reports one p-value.
+//
+//  frequency        ones among all bits
+//  serial hi/lo     pairs of the top / bottom bytes of consecutive words
+//  gap              gaps between words whose top 4 bits are 0
+//  birthday hi/lo   duplicate spacings of 4096 32-bit birthdays, top / bottom
+//                   half of the words, one sample per 16 blocks
+//  lincomp bit 0/63 linear complexity of 500-bit sequences of one bit of the
+//                   word, one sequence per block
+//  rank 64x64       ranks of 64x64 matrices of whole words, 8 per block
+//  rank low bytes   ranks of 64x64 matrices of the bottom bytes, 1 per block
+//
+// The bit and byte tests on the bottom of the words catch LCGs such as
+// mmix_engine and posix_engine, whose low bits have short periods.
+//
+// g++ -std=c++17 -O3 -march=native -pthread -I.. rng_test.cpp -o rng_test
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../any_engine.hpp"
+
+namespace
+{
+	enum : size_t { BLOCK = 1 << 16 }; // words
+	enum : unsigned { GAP_CLASSES = 64, BIRTHDAYS = 4096, LC_M = 500, LC_CLASSES = 7, RANK_CLASSES = 4, RANK_PER_BLOCK = 8, BIRTHDAY_EVERY = 16 };
+
+	// regularized incomplete gamma functions, Numerical Recipes 6.2
+	double gamma_series(double a, double x)
+	{
+		double ap = a, sum = 1.0 / a, del = sum;
+		for (int n = 0; n < 100000; ++n) {
+			ap += 1.0;
+			del *= x / ap;
+			sum += del;
+			if (std::fabs(del) < std::fabs(sum) * 1e-15) {
+				break;
+			}
+		}
+		return sum * std::exp(-x + a * std::log(x) - std::lgamma(a));
+	}
+	double gamma_fraction(double a, double x)
+	{
+		const double tiny = 1e-300;
+		double b = x + 1.0 - a, c = 1.0 / tiny, d = 1.0 / b, h = d;
+		for (int i = 1; i < 100000; ++i) {
+			const double an = -i * (i - a);
+			b += 2.0;
+			d = an * d + b;
+			if (std::fabs(d) < tiny) {
+				d = tiny;
+			}
+			c = b + an / c;
+			if (std::fabs(c) < tiny) {
+				c = tiny;
+			}
+			d = 1.0 / d;
+			const double del = d * c;
+			h *= del;
+			if (std::fabs(del - 1.0) < 1e-15) {
+				break;
+			}
+		}
+		return std::exp(-x + a * std::log(x) - std::lgamma(a)) * h;
+	}
+	// P(a, x) and Q(a, x) = 1 - P(a, x)
+	double gamma_p(double a, double x)
+	{
+		if (x <= 0) {
+			return 0;
+		}
+		return x < a + 1 ? gamma_series(a, x) : 1.0 - gamma_fraction(a, x);
+	}
+	double gamma_q(double a, double x)
+	{
+		if (x <= 0) {
+			return 1;
+		}
+		return x < a + 1 ? 1.0 - gamma_series(a, x) : gamma_fraction(a, x);
+	}
+
+	double chi_square_p(double chi2, unsigned df)
+	{
+		return gamma_q(df / 2.0, chi2 / 2.0);
+	}
+	double chi_square(const uint64_t *observed, const double *prob, unsigned classes, uint64_t total)
+	{
+		double chi2 = 0;
+		for (unsigned i = 0; i < classes; ++i) {
+			const double expected = total * prob[i];
+			chi2 += (observed[i] - expected) * (observed[i] - expected) / expected;
+		}
+		return chi2;
+	}
+	// P(X > k) + P(X = k) / 2 of a Poisson count, small for too many events and
+	// close to 1 for too few, like the chi-square p-values
+	double poisson_p(uint64_t k, double lambda)
+	{
+		const double at_least = k == 0 ? 1.0 : gamma_p(static_cast<double>(k), lambda);
+		const double above = gamma_p(k + 1.0, lambda);
+		return (at_least + above) / 2;
+	}
+
+	// probability that a random m x n GF(2) matrix has rank r
+	double rank_probability(int r, int m, int n)
+	{
+		double p = std::ldexp(1.0, r * (n + m - r) - n * m);
+		for (int i = 0; i < r; ++i) {
+			p *= (1 - std::ldexp(1.0, i - n)) * (1 - std::ldexp(1.0, i - m)) / (1 - std::ldexp(1.0, i - r));
+		}
+		return p;
+	}
+	int rank64(uint64_t (&row)[64])
+	{
+		int rank = 0;
+		for (int bit = 63; bit >= 0 && rank < 64; --bit) {
+			const uint64_t mask = uint64_t(1) << bit;
+			int pivot = rank;
+			while (pivot < 64 && !(row[pivot] & mask)) {
+				++pivot;
+			}
+			if (pivot == 64) {
+				continue;
+			}
+			std::swap(row[rank], row[pivot]);
+			for (int i = rank + 1; i < 64; ++i) {
+				if (row[i] & mask) {
+					row[i] ^= row[rank];
+				}
+			}
+			++rank;
+		}
+		return rank;
+	}
+
+	// Berlekamp-Massey over GF(2)
+	int linear_complexity(const unsigned char *s, int n)
+	{
+		std::vector<unsigned char> c(n + 1), b(n + 1), t(n + 1);
+		c[0] = b[0] = 1;
+		int l = 0, m = -1;
+		for (int i = 0; i < n; ++i) {
+			unsigned char d = s[i];
+			for (int j = 1; j <= l; ++j) {
+				d ^= c[j] & s[i - j];
+			}
+			if (d) {
+				t = c;
+				for (int j = 0; j + i - m <= n; ++j) {
+					c[j + i - m] ^= b[j];
+				}
+				if (2 * l <= i) {
+					l = i + 1 - l;
+					m = i;
+					b = t;
+				}
+			}
+		}
+		return l;
+	}
+
+	struct counts
+	{
+		uint64_t words = 0, ones = 0;
+		std::vector<uint64_t> serial_hi = std::vector<uint64_t>(65536), serial_lo = std::vector<uint64_t>(65536);
+		uint64_t gap[GAP_CLASSES] = {}, gaps = 0;
+		uint64_t birthday_hi = 0, birthday_lo = 0, birthday_samples = 0;
+		uint64_t lc0[LC_CLASSES] = {}, lc63[LC_CLASSES] = {}, lc_samples = 0;
+		uint64_t rank_full[RANK_CLASSES] = {}, rank_low[RANK_CLASSES] = {}, rank_full_samples = 0, rank_low_samples = 0;
+
+		counts& operator+=(const counts &o)
+		{
+			words += o.words;
+			ones += o.ones;
+			for (size_t i = 0; i < serial_hi.size(); ++i) {
+				serial_hi[i] += o.serial_hi[i];
+				serial_lo[i] += o.serial_lo[i];
+			}
+			for (unsigned i = 0; i < GAP_CLASSES; ++i) {
+				gap[i] += o.gap[i];
+			}
+			gaps += o.gaps;
+			birthday_hi += o.birthday_hi;
+			birthday_lo += o.birthday_lo;
+			birthday_samples += o.birthday_samples;
+			for (unsigned i = 0; i < LC_CLASSES; ++i) {
+				lc0[i] += o.lc0[i];
+				lc63[i] += o.lc63[i];
+			}
+			lc_samples += o.lc_samples;
+			for (unsigned i = 0; i < RANK_CLASSES; ++i) {
+				rank_full[i] += o.rank_full[i];
+				rank_low[i] += o.rank_low[i];
+			}
+			rank_full_samples += o.rank_full_samples;
+			rank_low_samples += o.rank_low_samples;
+			return *this;
+		}
+	};
+
+	class tester
+	{
+	public:
+		explicit tester(counts &c) : c(c) {}
+
+		void block(const uint64_t *w)
+		{
+			for (size_t i = 0; i < BLOCK; i += 2) {
+				c.ones += popcount(w[i]) + popcount(w[i + 1]);
+				++c.serial_hi[(w[i] >> 56) << 8 | (w[i + 1] >> 56)];
+				++c.serial_lo[(w[i] & 0xff) << 8 | (w[i + 1] & 0xff)];
+			}
+			for (size_t i = 0; i < BLOCK; ++i) {
+				if (w[i] >> 60) {
+					++gap_length;
+				} else {
+					++c.gap[std::min<uint64_t>(gap_length, GAP_CLASSES - 1)];
+					++c.gaps;
+					gap_length = 0;
+				}
+			}
+			c.words += BLOCK;
+
+			if (++blocks % BIRTHDAY_EVERY == 0) {
+				c.birthday_hi += birthday(w, 32);
+				c.birthday_lo += birthday(w, 0);
+				++c.birthday_samples;
+			}
+
+			unsigned char s0[LC_M], s63[LC_M];
+			for (unsigned i = 0; i < LC_M; ++i) {
+				s0[i] = w[i] & 1;
+				s63[i] = w[i] >> 63;
+			}
+			++c.lc0[lc_class(linear_complexity(s0, LC_M))];
+			++c.lc63[lc_class(linear_complexity(s63, LC_M))];
+			++c.lc_samples;
+
+			for (unsigned k = 0; k < RANK_PER_BLOCK; ++k) {
+				uint64_t m[64];
+				std::copy(w + 64 * k, w + 64 * (k + 1), m);
+				++c.rank_full[rank_class(rank64(m))];
+			}
+			c.rank_full_samples += RANK_PER_BLOCK;
+			uint64_t m[64];
+			for (unsigned r = 0; r < 64; ++r) {
+				m[r] = 0;
+				for (unsigned j = 0; j < 8; ++j) {
+					m[r] = m[r] << 8 | (w[8 * r + j] & 0xff);
+				}
+			}
+			++c.rank_low[rank_class(rank64(m))];
+			++c.rank_low_samples;
+		}
+
+	private:
+		counts &c;
+		uint64_t gap_length = 0, blocks = 0;
+
+		static unsigned popcount(uint64_t x)
+		{
+#if defined(__GNUC__)
+			return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+			unsigned n = 0;
+			for (; x; x &= x - 1) {
+				++n;
+			}
+			return n;
+#endif
+		}
+		// number of duplicate values among the sorted spacings
+		static unsigned birthday(const uint64_t *w, int shift)
+		{
+			uint32_t day[BIRTHDAYS];
+			for (unsigned i = 0; i < BIRTHDAYS; ++i) {
+				day[i] = static_cast<uint32_t>(w[i] >> shift);
+			}
+			std::sort(day, day + BIRTHDAYS);
+			uint32_t spacing[BIRTHDAYS];
+			spacing[0] = day[0];
+			for (unsigned i = 1; i < BIRTHDAYS; ++i) {
+				spacing[i] = day[i] - day[i - 1];
+			}
+			std::sort(spacing, spacing + BIRTHDAYS);
+			unsigned dup = 0;
+			for (unsigned i = 1; i < BIRTHDAYS; ++i) {
+				dup += spacing[i] == spacing[i - 1];
+			}
+			return dup;
+		}
+		// NIST SP 800-22 2.10
+		static unsigned lc_class(int l)
+		{
+			const double m = LC_M;
+			const double mu = m / 2.0 + (9.0 + (LC_M % 2 ? 1 : -1)) / 36.0 - (m / 3.0 + 2.0 / 9.0) / std::ldexp(1.0, LC_M);
+			const double t = (LC_M % 2 ? -1 : 1) * (l - mu) + 2.0 / 9.0;
+			if (t <= -2.5) return 0;
+			if (t <= -1.5) return 1;
+			if (t <= -0.5) return 2;
+			if (t <= 0.5) return 3;
+			if (t <= 1.5) return 4;
+			if (t <= 2.5) return 5;
+			return 6;
+		}
+		// 64, 63, 62, <= 61
+		static unsigned rank_class(int r)
+		{
+			return static_cast<unsigned>(std::min(64 - r, 3));
+		}
+	};
+
+	struct result
+	{
+		std::string name;
+		double p;
+	};
+
+	std::vector<result> evaluate(const counts &c)
+	{
+		std::vector<result> r;
+		const double bits = 64.0 * c.words;
+		r.push_back({ "frequency", std::erfc(std::fabs(c.ones - bits / 2) / std::sqrt(bits / 4) / std::sqrt(2.0)) });
+
+		std::vector<double> uniform(65536, 1.0 / 65536);
+		r.push_back({ "serial hi", chi_square_p(chi_square(c.serial_hi.data(), uniform.data(), 65536, c.words / 2), 65535) });
+		r.push_back({ "serial lo", chi_square_p(chi_square(c.serial_lo.data(), uniform.data(), 65536, c.words / 2), 65535) });
+
+		double gap_prob[GAP_CLASSES];
+		for (unsigned i = 0; i < GAP_CLASSES; ++i) {
+			gap_prob[i] = (1.0 / 16) * std::pow(15.0 / 16, i);
+		}
+		gap_prob[GAP_CLASSES - 1] = std::pow(15.0 / 16, GAP_CLASSES - 1);
+		r.push_back({ "gap", chi_square_p(chi_square(c.gap, gap_prob, GAP_CLASSES, c.gaps), GAP_CLASSES - 1) });
+
+		// lambda = m^3 / (4n)
+		const double lambda = std::pow(double(BIRTHDAYS), 3) / (4 * std::ldexp(1.0, 32)) * c.birthday_samples;
+		r.push_back({ "birthday hi", poisson_p(c.birthday_hi, lambda) });
+		r.push_back({ "birthday lo", poisson_p(c.birthday_lo, lambda) });
+
+		const double lc_prob[LC_CLASSES] = { 0.010417, 0.03125, 0.125, 0.5, 0.25, 0.0625, 0.020833 };
+		r.push_back({ "lincomp bit 0", chi_square_p(chi_square(c.lc0, lc_prob, LC_CLASSES, c.lc_samples), LC_CLASSES - 1) });
+		r.push_back({ "lincomp bit 63", chi_square_p(chi_square(c.lc63, lc_prob, LC_CLASSES, c.lc_samples), LC_CLASSES - 1) });
+
+		double rank_prob[RANK_CLASSES] = { rank_probability(64, 64, 64), rank_probability(63, 64, 64), rank_probability(62, 64, 64) };
+		rank_prob[3] = 1 - rank_prob[0] - rank_prob[1] - rank_prob[2];
+		r.push_back({ "rank 64x64", chi_square_p(chi_square(c.rank_full, rank_prob, RANK_CLASSES, c.rank_full_samples), RANK_CLASSES - 1) });
+		r.push_back({ "rank low bytes", chi_square_p(chi_square(c.rank_low, rank_prob, RANK_CLASSES, c.rank_low_samples), RANK_CLASSES - 1) });
+		return r;
+	}
+
+	const char* verdict(double p)
+	{
+		const double q = std::min(p, 1 - p);
+		return q < 1e-10 ? "FAIL" : q < 1e-4 ? "suspicious" : "";
+	}
+
+	struct options
+	{
+		uint64_t seed = 1;
+		uint64_t bytes = uint64_t(64) << 30;
+		unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	};
+
+	int run(const std::string &name, const options &opt)
+	{
+		const uint64_t blocks = std::max<uint64_t>(1, opt.bytes / (BLOCK * sizeof(uint64_t)));
+		std::vector<counts> partial(opt.threads);
+		std::atomic<uint64_t> next{ 0 };
+
+		const auto start = std::chrono::steady_clock::now();
+		auto worker = [&](unsigned t) {
+			splitmix64_engine seeds(opt.seed);
+			seeds.discard(t);
+			any_engine eng(name, seeds());
+			tester test(partial[t]);
+			std::vector<uint64_t> buf(BLOCK);
+			while (next.fetch_add(1, std::memory_order_relaxed) < blocks) {
+				eng.fill(buf.data(), buf.data() + BLOCK);
+				test.block(buf.data());
+			}
+		};
+		std::vector<std::thread> pool;
+		for (unsigned t = 1; t < opt.threads; ++t) {
+			pool.emplace_back(worker, t);
+		}
+		worker(0);
+		for (auto &t : pool) {
+			t.join();
+		}
+		const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+
+		counts total;
+		for (auto &c : partial) {
+			total += c;
+		}
+		std::printf("%s, seed %llu, %.2f GiB on %u threads in %.1f s\n", name.c_str(), static_cast<unsigned long long>(opt.seed),
+			total.words * 8 / 1073741824.0, opt.threads, dt.count());
+		int failed = 0;
+		for (auto &r : evaluate(total)) {
+			std::printf("  %-16s p = %-12.6g %s\n", r.name.c_str(), r.p, verdict(r.p));
+			failed += std::min(r.p, 1 - r.p) < 1e-10;
+		}
+		return failed ? 1 : 0;
+	}
+
+	bool parse_size(const char *s, uint64_t &value)
+	{
+		char *end;
+		value = std::strtoull(s, &end, 0);
+		if (end == s) {
+			return false;
+		}
+		switch (*end) {
+		case 'T': case 't': value <<= 10; [[fallthrough]];
+		case 'G': case 'g': value <<= 10; [[fallthrough]];
+		case 'M': case 'm': value <<= 10; [[fallthrough]];
+		case 'K': case 'k': value <<= 10; ++end; break;
+		default: break;
+		}
+		return *end == '\0';
+	}
+
+	int usage()
+	{
+		std::fprintf(stderr,
+			"usage: rng_test <engine|all> [seed] [-n bytes] [-t threads]\n"
+			"  -n  output tested per engine (suffix K, M, G, T), default 64G\n"
+			"  -t  threads, default: all cores\n"
+			"exit status 1 when a test fails (p < 1e-10 or p > 1 - 1e-10)\n"
+			"engines:");
+		for (auto &name : any_engine::names()) {
+			std::fprintf(stderr, " %s", name.c_str());
+		}
+		std::fprintf(stderr, "\n");
+		return 2;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		return usage();
+	}
+	options opt;
+	for (int i = 2; i < argc; ++i) {
+		const std::string arg = argv[i];
+		uint64_t value;
+		if (arg == "-n" && i + 1 < argc && parse_size(argv[i + 1], value)) {
+			opt.bytes = value;
+			++i;
+		} else if (arg == "-t" && i + 1 < argc && parse_size(argv[i + 1], value) && value > 0) {
+			opt.threads = static_cast<unsigned>(value);
+			++i;
+		} else if (i == 2 && parse_size(argv[i], value)) {
+			opt.seed = value;
+		} else {
+			return usage();
+		}
+	}
+
+	int status = 0;
+	if (std::strcmp(argv[1], "all") == 0) {
+		for (auto &name : any_engine::names()) {
+			status |= run(name, opt);
+		}
+	} else if (any_engine::contains(argv[1])) {
+		status = run(argv[1], opt);
+	} else {
+		std::fprintf(stderr, "rng_test: unknown engine '%s'\n", argv[1]);
+		return usage();
+	}
+	return status;
+}
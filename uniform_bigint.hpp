@@ -0,0 +1,483 @@
+#ifndef UNIFORM_BIGINT_H
+#define UNIFORM_BIGINT_H
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include "rand_util.hpp"
+
+// Uniform integers wider than 64 bits: uniform_bigint<Bits> on little-endian
+// arrays of 64-bit words, and uniform_uint128 on unsigned __int128 where the
+// compiler has it. The range [a, b] is inclusive, as for
+// std::uniform_int_distribution, so [0, 2^Bits - 1] can be asked for.
+//
+// A value is floor(range * U), U a uniform fraction whose bits are drawn
+// lazily: the first block of L bits R gives floor(range * R / 2^L) and a
+// remainder, and only when the bits still to come could carry into the result
+// is another block drawn, until they cannot. That is exact with
+// multiplications alone, where Lemire's method needs a division for its
+// rejection threshold, and a further block is needed with probability below
+// range / 2^L. Blocks are whole engine calls of k bits for engines with 2^k
+// values (31 for glibc_engine, 32 for xoshiro128_engine, 64 for
+// xoshiro256_engine), as few as cover the range, or one more when that lowers
+// the expected count; powers of 2 and the full range take exactly
+// ceil(bits / k) calls.
+
+namespace uniform_bigint_detail
+{
+	// bits per engine call; engines without 2^k values go through rand_util::word64
+	template <typename URBG>
+	constexpr unsigned call_bits()
+	{
+		constexpr unsigned k = rand_util::engine_bits<URBG>();
+		return k == 0 || k > 64 ? 64 : k;
+	}
+	template <typename URBG>
+	uint64_t call(URBG &g)
+	{
+		if constexpr (call_bits<URBG>() == 64) {
+			return rand_util::word64(g);
+		} else {
+			return static_cast<uint64_t>(g() - URBG::min());
+		}
+	}
+
+	// n calls of k bits at bits s, s + k, ... of x[0, m), the rest zero
+	template <typename URBG>
+	void draw(URBG &g, unsigned n, unsigned s, uint64_t *x, size_t m)
+	{
+		constexpr unsigned k = call_bits<URBG>();
+		std::fill(x, x + m, 0);
+		for (unsigned i = 0, at = s; i < n; ++i, at += k) {
+			const uint64_t c = call(g);
+			const unsigned shift = at % 64;
+			x[at / 64] |= c << shift;
+			if (shift + k > 64) {
+				x[at / 64 + 1] |= c >> (64 - shift);
+			}
+		}
+	}
+
+	// p[0, m + w) = x[0, m) * y[0, w)
+	inline void mul(const uint64_t *x, size_t m, const uint64_t *y, size_t w, uint64_t *p)
+	{
+		std::fill(p, p + m + w, 0);
+		for (size_t i = 0; i < m; ++i) {
+			uint64_t carry = 0;
+			for (size_t j = 0; j < w; ++j) {
+				uint64_t lo, hi = rand_util::mulhi64(x[i], y[j], lo);
+				lo += carry;
+				hi += lo < carry;
+				p[i + j] += lo;
+				hi += p[i + j] < lo;
+				carry = hi;
+			}
+			p[i + w] = carry;
+		}
+	}
+	// whether x + y overflows m words
+	inline bool add_carries(const uint64_t *x, const uint64_t *y, size_t m)
+	{
+		bool carry = false;
+		for (size_t i = 0; i < m; ++i) {
+			const uint64_t sum = x[i] + y[i] + carry;
+			carry = carry ? sum <= x[i] : sum < x[i];
+		}
+		return carry;
+	}
+	// x += y mod 2^(64 m), returns the carry
+	inline bool add(uint64_t *x, const uint64_t *y, size_t m)
+	{
+		bool carry = false;
+		for (size_t i = 0; i < m; ++i) {
+			const uint64_t sum = x[i] + y[i] + carry;
+			carry = carry ? sum <= x[i] : sum < x[i];
+			x[i] = sum;
+		}
+		return carry;
+	}
+	// x += 1 mod 2^(64 m)
+	inline void increment(uint64_t *x, size_t m)
+	{
+		for (size_t i = 0; i < m && ++x[i] == 0; ++i) {
+		}
+	}
+	// x < y, m words
+	inline bool less(const uint64_t *x, const uint64_t *y, size_t m)
+	{
+		for (size_t i = m; i--;) {
+			if (x[i] != y[i]) {
+				return x[i] < y[i];
+			}
+		}
+		return false;
+	}
+	// out[0, m) = x[0, w) << s, s < 64, the result fitting m >= w words
+	inline void shift_left(const uint64_t *x, size_t w, unsigned s, uint64_t *out, size_t m)
+	{
+		std::fill(out, out + m, 0);
+		for (size_t i = 0; i < w; ++i) {
+			out[i] |= x[i] << s;
+			if (s && i + 1 < m) {
+				out[i + 1] |= x[i] >> (64 - s);
+			}
+		}
+	}
+	// out[0, w) = (2^(64 m) - x[0, m)) >> s, x != 0 and overwritten, the result fitting w <= m words
+	inline void negate_shift_right(uint64_t *x, size_t m, unsigned s, uint64_t *out, size_t w)
+	{
+		bool borrow = false;
+		for (size_t i = 0; i < m; ++i) {
+			const bool next = borrow || x[i] != 0;
+			x[i] = 0 - x[i] - borrow;
+			borrow = next;
+		}
+		for (size_t i = 0; i < w; ++i) {
+			out[i] = x[i] >> s;
+			if (s && i + 1 < m) {
+				out[i] |= x[i + 1] << (64 - s);
+			}
+		}
+	}
+
+	// floor(range * U) for range of w <= W words and bit length bits, not a power of 2
+	template <size_t W, typename URBG>
+	void bounded(const uint64_t *range, size_t w, unsigned bits, URBG &g, uint64_t *out)
+	{
+		constexpr unsigned k = call_bits<URBG>();
+		unsigned n = (bits + k - 1) / k;
+		// with e spare bits a block is drawn again about n 2^-e times per value
+		const unsigned e = n * k - bits;
+		if (e < 63 && (uint64_t(1) << e) < n) {
+			++n;
+		}
+		const size_t m = (n * k + 63) / 64;
+		const unsigned s = static_cast<unsigned>(64 * m - n * k);
+
+		// the remainder is below 2^(64 m), the rest of U adds less than range << s to it
+		uint64_t r[W + 2], p[2 * W + 2], tail[W + 2], d[W];
+		shift_left(range, w, s, tail, m);
+		draw(g, n, s, r, m);
+		mul(r, m, range, w, p);
+		std::copy(p + m, p + m + w, out);
+		if (!add_carries(p, tail, m)) {
+			return;
+		}
+		// the rest of U adds one when range * U' >= d, U' uniform again; a block
+		// puts range * U' in [h, h + 2), and only h = d - 1 leaves it open,
+		// when the same holds one block further on with d from the new remainder
+		negate_shift_right(p, m, s, d, w);
+		for (;;) {
+			draw(g, n, s, r, m);
+			mul(r, m, range, w, p);
+			uint64_t *h = p + m;
+			if (!less(h, d, w)) {
+				increment(out, w);
+				return;
+			}
+			increment(h, w);
+			if (less(h, d, w) || !add_carries(p, tail, m)) {
+				return;
+			}
+			negate_shift_right(p, m, s, d, w);
+		}
+	}
+}
+
+template <size_t Bits>
+class uniform_bigint
+{
+	static_assert(Bits > 0, "uniform_bigint needs at least one bit");
+
+public:
+	enum : size_t { WORDS = (Bits + 63) / 64 };
+	using result_type = std::array<uint64_t, WORDS>; // little-endian 64-bit words
+
+	class param_type
+	{
+	public:
+		using distribution_type = uniform_bigint;
+
+		param_type() : param_type(result_type{}, top()) {}
+		// a <= b < 2^Bits
+		param_type(const result_type &a, const result_type &b) : a_(a), b_(b)
+		{
+			init();
+		}
+
+		const result_type& a() const { return a_; }
+		const result_type& b() const { return b_; }
+
+		friend bool operator==(const param_type &lhs, const param_type &rhs)
+		{
+			return lhs.a_ == rhs.a_ && lhs.b_ == rhs.b_;
+		}
+		friend bool operator!=(const param_type &lhs, const param_type &rhs)
+		{
+			return !(lhs == rhs);
+		}
+
+	private:
+		friend class uniform_bigint;
+
+		result_type a_, b_;
+		result_type range; // b - a + 1, 0 for 2^(64 WORDS)
+		size_t words;      // of range
+		unsigned bits;     // bit length of range, or log2 of a power of 2
+		bool power_of_2;
+
+		void init()
+		{
+			using namespace uniform_bigint_detail;
+			// b - a + 1 as b + ~a + 2 mod 2^(64 WORDS)
+			result_type not_a, two = {};
+			for (size_t i = 0; i < WORDS; ++i) {
+				not_a[i] = ~a_[i];
+			}
+			two[0] = 2;
+			range = b_;
+			add(range.data(), not_a.data(), WORDS);
+			add(range.data(), two.data(), WORDS);
+			words = WORDS;
+			while (words && range[words - 1] == 0) {
+				--words;
+			}
+			if (words == 0) { // 2^(64 WORDS)
+				power_of_2 = true;
+				bits = 64 * WORDS;
+				return;
+			}
+			const uint64_t top_word = range[words - 1];
+			unsigned top_bits = 0;
+			for (uint64_t t = top_word; t; t >>= 1) {
+				++top_bits;
+			}
+			bits = static_cast<unsigned>(64 * (words - 1)) + top_bits;
+			power_of_2 = (top_word & (top_word - 1)) == 0
+				&& std::all_of(range.begin(), range.begin() + (words - 1), [](uint64_t x) { return x == 0; });
+			if (power_of_2) {
+				--bits;
+			}
+		}
+	};
+
+	uniform_bigint() = default;
+	uniform_bigint(const result_type &a, const result_type &b) : par(a, b) {}
+	explicit uniform_bigint(const param_type &p) : par(p) {}
+
+	void reset() {}
+
+	const result_type& a() const { return par.a(); }
+	const result_type& b() const { return par.b(); }
+	param_type param() const { return par; }
+	void param(const param_type &p) { par = p; }
+	result_type min() const { return par.a(); }
+	result_type max() const { return par.b(); }
+
+	template <typename URBG>
+	result_type operator()(URBG &g)
+	{
+		return (*this)(g, par);
+	}
+	template <typename URBG>
+	result_type operator()(URBG &g, const param_type &p)
+	{
+		using namespace uniform_bigint_detail;
+		constexpr unsigned k = call_bits<URBG>();
+		result_type x = {};
+		if (p.power_of_2) {
+			// exactly p.bits bits
+			uint64_t r[WORDS + 1];
+			draw(g, (p.bits + k - 1) / k, 0, r, WORDS + 1);
+			std::copy(r, r + WORDS, x.begin());
+			if (p.bits < 64 * WORDS) {
+				x[p.bits / 64] &= (uint64_t(1) << (p.bits % 64)) - 1;
+				std::fill(x.begin() + (p.bits / 64 + 1), x.end(), 0);
+			}
+		} else {
+			bounded<WORDS>(p.range.data(), p.words, p.bits, g, x.data());
+		}
+		add(x.data(), p.a_.data(), WORDS);
+		return x;
+	}
+
+	// bulk sampling
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g)
+	{
+		generate(first, last, g, par);
+	}
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g, const param_type &p)
+	{
+		for (; first != last; ++first) {
+			*first = (*this)(g, p);
+		}
+	}
+
+	friend bool operator==(const uniform_bigint &lhs, const uniform_bigint &rhs)
+	{
+		return lhs.par == rhs.par;
+	}
+	friend bool operator!=(const uniform_bigint &lhs, const uniform_bigint &rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <typename CharT, typename Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits> &os, const uniform_bigint &d)
+	{
+		for (auto word : d.a()) {
+			os << word << ' ';
+		}
+		for (size_t i = 0; i < WORDS; ++i) {
+			os << d.b()[i] << (i + 1 < WORDS ? " " : "");
+		}
+		return os;
+	}
+	template <typename CharT, typename Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits> &is, uniform_bigint &d)
+	{
+		result_type a, b;
+		for (auto &word : a) {
+			is >> word;
+		}
+		for (auto &word : b) {
+			is >> word;
+		}
+		if (is) {
+			d.par = param_type(a, b);
+		}
+		return is;
+	}
+
+private:
+	param_type par;
+
+	static result_type top()
+	{
+		result_type t;
+		t.fill(std::numeric_limits<uint64_t>::max());
+		if (Bits % 64) {
+			t[WORDS - 1] = (uint64_t(1) << (Bits % 64)) - 1;
+		}
+		return t;
+	}
+};
+
+#if defined(__SIZEOF_INT128__)
+// uniform_bigint<128> on unsigned __int128
+class uniform_uint128
+{
+	using base = uniform_bigint<128>;
+
+public:
+	using result_type = unsigned __int128;
+
+	class param_type
+	{
+	public:
+		using distribution_type = uniform_uint128;
+
+		param_type() : param_type(0, ~result_type(0)) {}
+		// a <= b
+		param_type(result_type a, result_type b) : p(words(a), words(b)) {}
+
+		result_type a() const { return value(p.a()); }
+		result_type b() const { return value(p.b()); }
+
+		friend bool operator==(const param_type &lhs, const param_type &rhs)
+		{
+			return lhs.p == rhs.p;
+		}
+		friend bool operator!=(const param_type &lhs, const param_type &rhs)
+		{
+			return !(lhs == rhs);
+		}
+
+	private:
+		friend class uniform_uint128;
+
+		base::param_type p;
+	};
+
+	uniform_uint128() = default;
+	uniform_uint128(result_type a, result_type b) : par(a, b) {}
+	explicit uniform_uint128(const param_type &p) : par(p) {}
+
+	void reset() {}
+
+	result_type a() const { return par.a(); }
+	result_type b() const { return par.b(); }
+	param_type param() const { return par; }
+	void param(const param_type &p) { par = p; }
+	result_type min() const { return par.a(); }
+	result_type max() const { return par.b(); }
+
+	template <typename URBG>
+	result_type operator()(URBG &g)
+	{
+		return (*this)(g, par);
+	}
+	template <typename URBG>
+	result_type operator()(URBG &g, const param_type &p)
+	{
+		return value(base()(g, p.p));
+	}
+
+	// bulk sampling
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g)
+	{
+		generate(first, last, g, par);
+	}
+	template <typename OutputIt, typename URBG>
+	void generate(OutputIt first, OutputIt last, URBG &g, const param_type &p)
+	{
+		for (; first != last; ++first) {
+			*first = (*this)(g, p);
+		}
+	}
+
+	friend bool operator==(const uniform_uint128 &lhs, const uniform_uint128 &rhs)
+	{
+		return lhs.par == rhs.par;
+	}
+	friend bool operator!=(const uniform_uint128 &lhs, const uniform_uint128 &rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	// the 64-bit words of a and b, low first, as uniform_bigint<128>
+	template <typename CharT, typename Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits> &os, const uniform_uint128 &d)
+	{
+		return os << base(words(d.a()), words(d.b()));
+	}
+	template <typename CharT, typename Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits> &is, uniform_uint128 &d)
+	{
+		base b;
+		if (is >> b) {
+			d.par = param_type(value(b.a()), value(b.b()));
+		}
+		return is;
+	}
+
+private:
+	param_type par;
+
+	static base::result_type words(result_type x)
+	{
+		return { static_cast<uint64_t>(x), static_cast<uint64_t>(x >> 64) };
+	}
+	static result_type value(const base::result_type &w)
+	{
+		return static_cast<result_type>(w[1]) << 64 | w[0];
+	}
+};
+#endif
+
+#endif // UNIFORM_BIGINT_H
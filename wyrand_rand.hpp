@@ -0,0 +1,67 @@
+#ifndef WYRAND_RANDOM_H
+#define WYRAND_RANDOM_H
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include "rand_util.hpp"
+#include "splitmix64_rand.hpp"
+
+/* wyrand by Wang Yi, released into the public domain (The Unlicense) */
+
+// https://github.com/wangyi-fudan/wyhash
+
+class wyrand_engine // wyrand
+{
+public:
+	using result_type = uint64_t;
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	static constexpr result_type default_seed = 1;
+
+	explicit wyrand_engine(result_type value = default_seed)
+	{
+		seed(value);
+	}
+	void seed(result_type value = default_seed)
+	{
+		s = splitmix64_engine{ value }();
+	}
+	result_type operator()()
+	{
+		s += 0xa0761d6478bd642f;
+		uint64_t lo;
+		const uint64_t hi = rand_util::mulhi64(s, s ^ 0xe7037ed1a0b428db, lo);
+		return hi ^ lo;
+	}
+	void discard(unsigned long long z)
+	{
+		s += z * 0xa0761d6478bd642f; // Weyl sequence, O(1)
+	}
+
+	friend bool operator==(const wyrand_engine &, const wyrand_engine &);
+	friend std::ostream& operator<<(std::ostream &, const wyrand_engine &);
+	friend std::istream& operator>>(std::istream &, wyrand_engine &);
+
+private:
+	uint64_t s;
+};
+
+bool operator==(const wyrand_engine &lhs, const wyrand_engine &rhs)
+{
+	return lhs.s == rhs.s;
+}
+bool operator!=(const wyrand_engine &lhs, const wyrand_engine &rhs)
+{
+	return !(lhs == rhs);
+}
+std::ostream& operator<<(std::ostream &os, const wyrand_engine &eng)
+{
+	return os << eng.s;
+}
+std::istream& operator>>(std::istream &is, wyrand_engine &eng)
+{
+	return is >> eng.s;
+}
+
+#endif // WYRAND_RANDOM_H
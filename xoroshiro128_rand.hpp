@@ -8,7 +8,9 @@
 #include <cstdint>
 #include <iosfwd>
 #include <limits>
+#include <type_traits>
 #include "splitmix64_rand.hpp"
+#include "xoshiro_scrambler.hpp"
 
 /*  Written in 2018 by David Blackman and Sebastiano Vigna (vigna@acm.org)
 
@@ -18,7 +20,8 @@ worldwide. This software is distributed without any warranty.
 
 See <http://creativecommons.org/publicdomain/zero/1.0/>. */
 
-class xoroshiro128_engine // xoroshiro128**
+template <typename Scrambler>
+class basic_xoroshiro128_engine // xoroshiro128+, xoroshiro128++, xoroshiro128**
 {
 public:
 	using result_type = uint64_t;
@@ -27,7 +30,7 @@ public:
 	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
 	static constexpr result_type default_seed = 1;
 
-	explicit xoroshiro128_engine(result_type value = default_seed)
+	explicit basic_xoroshiro128_engine(result_type value = default_seed)
 	{
 		seed(value);
 	}
@@ -39,11 +42,11 @@ public:
 	{
 		const uint64_t s0 = s[0];
 		uint64_t s1 = s[1];
-		const uint64_t result = rotl(s0 * 5, 7) * 9;
+		const uint64_t result = scramble(s0, s1);
 
 		s1 ^= s0;
-		s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
-		s[1] = rotl(s1, 37); // c
+		s[0] = rotl(s0, A) ^ s1 ^ (s1 << B); // a, b
+		s[1] = rotl(s1, C); // c
 
 		return result;
 	}
@@ -53,12 +56,58 @@ public:
 			(*this)();
 		}
 	}
+	// equivalent to 2^64 calls to operator()
+	void jump()
+	{
+		static const result_type JUMP[] = {
+			PLUSPLUS ? 0x2bd7a6a6e99c2ddc : 0xdf900294d8f554a5,
+			PLUSPLUS ? 0x0992ccaf6a6fca05 : 0x170865df4b3201fc
+		};
+
+		result_type t0 = 0, t1 = 0;
+		for (auto j : JUMP) {
+			for (int b = 0; b < 64; ++b) {
+				if (j & result_type(1) << b) {
+					t0 ^= s[0];
+					t1 ^= s[1];
+				}
+				(*this)();
+			}
+		}
+		s[0] = t0;
+		s[1] = t1;
+	}
+	// equivalent to 2^96 calls to operator()
+	void long_jump()
+	{
+		static const result_type LONG_JUMP[] = {
+			PLUSPLUS ? 0x360fd5f2cf8d5d99 : 0xd2a98b26625eee7b,
+			PLUSPLUS ? 0x9c6e6877736c46e3 : 0xdddf9b1090aa7ac1
+		};
+
+		result_type t0 = 0, t1 = 0;
+		for (auto j : LONG_JUMP) {
+			for (int b = 0; b < 64; ++b) {
+				if (j & result_type(1) << b) {
+					t0 ^= s[0];
+					t1 ^= s[1];
+				}
+				(*this)();
+			}
+		}
+		s[0] = t0;
+		s[1] = t1;
+	}
 
-	friend bool operator==(const xoroshiro128_engine &, const xoroshiro128_engine &);
-	friend std::ostream& operator<<(std::ostream &, const xoroshiro128_engine &);
-	friend std::istream& operator>>(std::istream &, xoroshiro128_engine &);
+	template <typename S> friend bool operator==(const basic_xoroshiro128_engine<S> &, const basic_xoroshiro128_engine<S> &);
+	template <typename S> friend std::ostream& operator<<(std::ostream &, const basic_xoroshiro128_engine<S> &);
+	template <typename S> friend std::istream& operator>>(std::istream &, basic_xoroshiro128_engine<S> &);
 
 private:
+	// xoroshiro128++ uses its own linear engine
+	static constexpr bool PLUSPLUS = std::is_same<Scrambler, xoshiro_scrambler::plusplus>::value;
+	enum : int { A = PLUSPLUS ? 49 : 24, B = PLUSPLUS ? 21 : 16, C = PLUSPLUS ? 28 : 37 };
+
 	static uint64_t rotl(const uint64_t x, int k)
 	{
 #ifdef _MSC_VER
@@ -68,24 +117,44 @@ private:
 #endif
 	}
 
+	static uint64_t scramble(const uint64_t s0, const uint64_t s1)
+	{
+		if constexpr (std::is_same<Scrambler, xoshiro_scrambler::plus>::value) {
+			return s0 + s1;
+		} else if constexpr (PLUSPLUS) {
+			return rotl(s0 + s1, 17) + s0;
+		} else {
+			static_assert(std::is_same<Scrambler, xoshiro_scrambler::starstar>::value, "unknown scrambler");
+			return rotl(s0 * 5, 7) * 9;
+		}
+	}
+
 	std::array<uint64_t, 2> s;
 };
 
-bool operator==(const xoroshiro128_engine &lhs, const xoroshiro128_engine &rhs)
+template <typename Scrambler>
+bool operator==(const basic_xoroshiro128_engine<Scrambler> &lhs, const basic_xoroshiro128_engine<Scrambler> &rhs)
 {
 	return lhs.s == rhs.s;
 }
-bool operator!=(const xoroshiro128_engine &lhs, const xoroshiro128_engine &rhs)
+template <typename Scrambler>
+bool operator!=(const basic_xoroshiro128_engine<Scrambler> &lhs, const basic_xoroshiro128_engine<Scrambler> &rhs)
 {
 	return !(lhs == rhs);
 }
-std::ostream& operator<<(std::ostream &os, const xoroshiro128_engine &eng)
+template <typename Scrambler>
+std::ostream& operator<<(std::ostream &os, const basic_xoroshiro128_engine<Scrambler> &eng)
 {
 	return os << eng.s[0] << ' ' << eng.s[1];
 }
-std::istream& operator>>(std::istream &is, xoroshiro128_engine &eng)
+template <typename Scrambler>
+std::istream& operator>>(std::istream &is, basic_xoroshiro128_engine<Scrambler> &eng)
 {
 	return is >> eng.s[0] >> eng.s[1];
 }
 
+using xoroshiro128plus_engine = basic_xoroshiro128_engine<xoshiro_scrambler::plus>;
+using xoroshiro128plusplus_engine = basic_xoroshiro128_engine<xoshiro_scrambler::plusplus>;
+using xoroshiro128_engine = basic_xoroshiro128_engine<xoshiro_scrambler::starstar>;
+
 #endif // XOROSHIRO128_RANDOM_H
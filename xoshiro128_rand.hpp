@@ -59,6 +59,50 @@ public:
 			(*this)();
 		}
 	}
+	// equivalent to 2^64 calls to operator()
+	void jump()
+	{
+		static const result_type JUMP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+
+		result_type t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+		for (auto j : JUMP) {
+			for (int b = 0; b < 32; ++b) {
+				if (j & result_type(1) << b) {
+					t0 ^= s[0];
+					t1 ^= s[1];
+					t2 ^= s[2];
+					t3 ^= s[3];
+				}
+				(*this)();
+			}
+		}
+		s[0] = t0;
+		s[1] = t1;
+		s[2] = t2;
+		s[3] = t3;
+	}
+	// equivalent to 2^96 calls to operator()
+	void long_jump()
+	{
+		static const result_type LONG_JUMP[] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+
+		result_type t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+		for (auto j : LONG_JUMP) {
+			for (int b = 0; b < 32; ++b) {
+				if (j & result_type(1) << b) {
+					t0 ^= s[0];
+					t1 ^= s[1];
+					t2 ^= s[2];
+					t3 ^= s[3];
+				}
+				(*this)();
+			}
+		}
+		s[0] = t0;
+		s[1] = t1;
+		s[2] = t2;
+		s[3] = t3;
+	}
 
 	friend bool operator==(const xoshiro128_engine &, const xoshiro128_engine &);
 	friend std::ostream& operator<<(std::ostream &, const xoshiro128_engine &);
@@ -8,7 +8,9 @@
 #include <cstdint>
 #include <iosfwd>
 #include <limits>
+#include <type_traits>
 #include "splitmix64_rand.hpp"
+#include "xoshiro_scrambler.hpp"
 
 /*  Written in 2018 by David Blackman and Sebastiano Vigna (vigna@acm.org)
 
@@ -18,7 +20,8 @@ worldwide. This software is distributed without any warranty.
 
 See <http://creativecommons.org/publicdomain/zero/1.0/>. */
 
-class xoshiro256_engine // xoshiro256**
+template <typename Scrambler>
+class basic_xoshiro256_engine // xoshiro256+, xoshiro256++, xoshiro256**
 {
 public:
 	using result_type = uint64_t;
@@ -27,7 +30,7 @@ public:
 	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
 	static constexpr result_type default_seed = 1;
 
-	explicit xoshiro256_engine(result_type value = default_seed)
+	explicit basic_xoshiro256_engine(result_type value = default_seed)
 	{
 		seed(value);
 	}
@@ -37,7 +40,7 @@ public:
 	}
 	result_type operator()()
 	{
-		const uint64_t result = rotl(s[1] * 5, 7) * 9;
+		const uint64_t result = scramble();
 
 		const uint64_t t = s[1] << 17;
 
@@ -58,10 +61,54 @@ public:
 			(*this)();
 		}
 	}
+	// equivalent to 2^128 calls to operator()
+	void jump()
+	{
+		static const result_type JUMP[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+
+		result_type t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+		for (auto j : JUMP) {
+			for (int b = 0; b < 64; ++b) {
+				if (j & result_type(1) << b) {
+					t0 ^= s[0];
+					t1 ^= s[1];
+					t2 ^= s[2];
+					t3 ^= s[3];
+				}
+				(*this)();
+			}
+		}
+		s[0] = t0;
+		s[1] = t1;
+		s[2] = t2;
+		s[3] = t3;
+	}
+	// equivalent to 2^192 calls to operator()
+	void long_jump()
+	{
+		static const result_type LONG_JUMP[] = { 0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635 };
+
+		result_type t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+		for (auto j : LONG_JUMP) {
+			for (int b = 0; b < 64; ++b) {
+				if (j & result_type(1) << b) {
+					t0 ^= s[0];
+					t1 ^= s[1];
+					t2 ^= s[2];
+					t3 ^= s[3];
+				}
+				(*this)();
+			}
+		}
+		s[0] = t0;
+		s[1] = t1;
+		s[2] = t2;
+		s[3] = t3;
+	}
 
-	friend bool operator==(const xoshiro256_engine &, const xoshiro256_engine &);
-	friend std::ostream& operator<<(std::ostream &, const xoshiro256_engine &);
-	friend std::istream& operator>>(std::istream &, xoshiro256_engine &);
+	template <typename S> friend bool operator==(const basic_xoshiro256_engine<S> &, const basic_xoshiro256_engine<S> &);
+	template <typename S> friend std::ostream& operator<<(std::ostream &, const basic_xoshiro256_engine<S> &);
+	template <typename S> friend std::istream& operator>>(std::istream &, basic_xoshiro256_engine<S> &);
 
 private:
 	static uint64_t rotl(const uint64_t x, int k)
@@ -73,24 +120,44 @@ private:
 #endif
 	}
 
+	uint64_t scramble() const
+	{
+		if constexpr (std::is_same<Scrambler, xoshiro_scrambler::plus>::value) {
+			return s[0] + s[3];
+		} else if constexpr (std::is_same<Scrambler, xoshiro_scrambler::plusplus>::value) {
+			return rotl(s[0] + s[3], 23) + s[0];
+		} else {
+			static_assert(std::is_same<Scrambler, xoshiro_scrambler::starstar>::value, "unknown scrambler");
+			return rotl(s[1] * 5, 7) * 9;
+		}
+	}
+
 	std::array<uint64_t, 4> s;
 };
 
-bool operator==(const xoshiro256_engine &lhs, const xoshiro256_engine &rhs)
+template <typename Scrambler>
+bool operator==(const basic_xoshiro256_engine<Scrambler> &lhs, const basic_xoshiro256_engine<Scrambler> &rhs)
 {
 	return lhs.s == rhs.s;
 }
-bool operator!=(const xoshiro256_engine &lhs, const xoshiro256_engine &rhs)
+template <typename Scrambler>
+bool operator!=(const basic_xoshiro256_engine<Scrambler> &lhs, const basic_xoshiro256_engine<Scrambler> &rhs)
 {
 	return !(lhs == rhs);
 }
-std::ostream& operator<<(std::ostream &os, const xoshiro256_engine &eng)
+template <typename Scrambler>
+std::ostream& operator<<(std::ostream &os, const basic_xoshiro256_engine<Scrambler> &eng)
 {
 	return os << eng.s[0] << ' ' << eng.s[1] << ' ' << eng.s[2] << ' ' << eng.s[3];
 }
-std::istream& operator>>(std::istream &is, xoshiro256_engine &eng)
+template <typename Scrambler>
+std::istream& operator>>(std::istream &is, basic_xoshiro256_engine<Scrambler> &eng)
 {
 	return is >> eng.s[0] >> eng.s[1] >> eng.s[2] >> eng.s[3];
 }
 
+using xoshiro256plus_engine = basic_xoshiro256_engine<xoshiro_scrambler::plus>;
+using xoshiro256plusplus_engine = basic_xoshiro256_engine<xoshiro_scrambler::plusplus>;
+using xoshiro256_engine = basic_xoshiro256_engine<xoshiro_scrambler::starstar>;
+
 #endif // XOSHIRO256_RANDOM_H
@@ -0,0 +1,17 @@
+#ifndef XOSHIRO_SCRAMBLER_H
+#define XOSHIRO_SCRAMBLER_H
+
+// Output functions of the xoshiro/xoroshiro generators.
+// Blackman, Vigna, "Scrambled Linear Pseudorandom Number Generators", 2018
+//  plus     : fastest, weak low bits, fine for floating-point output
+//  plusplus : no multiplication, vectorizes well
+//  starstar : all bits pass the tests, two multiplications
+
+namespace xoshiro_scrambler
+{
+	struct plus {};
+	struct plusplus {};
+	struct starstar {};
+}
+
+#endif // XOSHIRO_SCRAMBLER_H